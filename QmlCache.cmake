@@ -0,0 +1,40 @@
+#precompiles the qml and js files of the packages with qmlcachegen, the
+#.qmlc/.jsc units are installed next to their sources and Qt loads them
+#instead of compiling the files at startup
+option(BUILD_QML_CACHE "Precompile the QML of the shell, containment and plasmoid packages" ON)
+
+if(BUILD_QML_CACHE)
+    get_target_property(_qmakeExecutable Qt5::qmake IMPORTED_LOCATION)
+    get_filename_component(_qtBinDir ${_qmakeExecutable} DIRECTORY)
+    find_program(QMLCACHEGEN_EXECUTABLE NAMES qmlcachegen qmlcachegen-qt5 HINTS ${_qtBinDir})
+endif()
+
+if(NOT BUILD_QML_CACHE)
+    message(STATUS "QML cache: disabled, the packages are compiled at runtime")
+
+elseif(NOT QMLCACHEGEN_EXECUTABLE)
+    message(WARNING "-- qmlcachegen: not found. The QML of the packages will *not* be precompiled")
+
+else()
+    add_custom_target(qmlcache ALL)
+
+    foreach(_package shell containment plasmoid)
+        set(_packageDir ${CMAKE_CURRENT_BINARY_DIR}/${_package}/release)
+        file(GLOB_RECURSE _sources ${_packageDir}/contents/*.qml ${_packageDir}/contents/*.js)
+        set(_units)
+
+        foreach(_source ${_sources})
+            #Qt looks for the unit at the source path with a "c" appended
+            set(_unit ${_source}c)
+
+            add_custom_command(OUTPUT ${_unit}
+                COMMAND ${QMLCACHEGEN_EXECUTABLE} -o ${_unit} ${_source}
+                DEPENDS ${_source})
+
+            list(APPEND _units ${_unit})
+        endforeach()
+
+        add_custom_target(qmlcache-${_package} DEPENDS ${_units})
+        add_dependencies(qmlcache qmlcache-${_package})
+    endforeach()
+endif()
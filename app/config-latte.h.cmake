@@ -1,5 +1,9 @@
 #cmakedefine01 HAVE_X11
 
+#cmakedefine01 HAVE_XCB_SHM
+
+#cmakedefine01 HAVE_AVX2
+
 #cmakedefine VERSION "@VERSION@"
 
 #cmakedefine WEBSITE "@WEBSITE@"
@@ -0,0 +1,252 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "containmentindex.h"
+#include "layoutcache.h"
+#include "../liblattedock/startuptrace.h"
+
+#include <algorithm>
+
+#include <QDebug>
+
+#include <Plasma/Applet>
+
+#include <KPackage/Package>
+
+namespace Latte {
+
+namespace {
+const QString LatteContainment = QStringLiteral("org.kde.latte.containment");
+const QString LatteTasks = QStringLiteral("org.kde.latte.plasmoid");
+}
+
+ContainmentIndex::ContainmentIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ContainmentIndex::~ContainmentIndex()
+{
+}
+
+void ContainmentIndex::load(const KConfigGroup &containments)
+{
+    LATTE_TRACE_SCOPE("ContainmentIndex::load");
+
+    m_entries.clear();
+
+    foreach (const QString &cId, containments.groupList()) {
+        const KConfigGroup group = containments.group(cId);
+        ContainmentInfo info;
+        info.id = cId.toUInt();
+        info.plugin = group.readEntry("plugin", QString());
+        readConfig(info, group);
+
+        const KConfigGroup appletEntries = group.group("Applets");
+
+        foreach (const QString &appId, appletEntries.groupList()) {
+            info.applets[appId.toUInt()] = appletEntries.group(appId).readEntry("plugin", QString());
+        }
+
+        updateTasksPlasmoid(info);
+        m_entries[info.id] = info;
+    }
+
+    qDebug() << "containment index loaded, entries:" << m_entries.count();
+}
+
+bool ContainmentIndex::loadCache(const QString &configFile)
+{
+    LATTE_TRACE_SCOPE("ContainmentIndex::loadCache");
+
+    QList<ContainmentInfo> entries;
+
+    if (!LayoutCache::read(LayoutCache::cacheFile(configFile), configFile, entries)) {
+        return false;
+    }
+
+    m_entries.clear();
+
+    for (auto &info : entries) {
+        updateTasksPlasmoid(info);
+        m_entries[info.id] = info;
+    }
+
+    qDebug() << "containment index loaded from the layout cache, entries:" << m_entries.count();
+
+    return true;
+}
+
+bool ContainmentIndex::saveCache(const QString &configFile) const
+{
+    QList<ContainmentInfo> entries;
+
+    for (uint id : ids()) {
+        entries << m_entries.value(id);
+    }
+
+    return LayoutCache::write(LayoutCache::cacheFile(configFile), configFile, entries);
+}
+
+void ContainmentIndex::readConfig(ContainmentInfo &info, const KConfigGroup &group) const
+{
+    info.lastScreen = group.readEntry("lastScreen", -1);
+    info.onPrimary = group.readEntry("onPrimary", true);
+    info.location = static_cast<Plasma::Types::Location>(group.readEntry("location", (int)Plasma::Types::BottomEdge));
+    info.session = static_cast<Dock::SessionType>(group.readEntry("session", (int)Dock::DefaultSession));
+}
+
+void ContainmentIndex::updateTasksPlasmoid(ContainmentInfo &info) const
+{
+    info.hasTasksPlasmoid = std::any_of(info.applets.constBegin(), info.applets.constEnd(), [](const QString & plugin) {
+        return plugin == LatteTasks;
+    });
+}
+
+void ContainmentIndex::track(Plasma::Containment *containment)
+{
+    if (!containment) {
+        return;
+    }
+
+    const uint id = containment->id();
+
+    if (m_entries.contains(id) && m_entries[id].containment == containment) {
+        return;
+    }
+
+    ContainmentInfo &info = m_entries[id];
+    info.id = id;
+    info.containment = containment;
+    info.plugin = containment->kPackage().isValid() ? containment->kPackage().metadata().pluginId() : info.plugin;
+    info.screen = containment->screen();
+    info.location = containment->location();
+    readConfig(info, containment->config());
+    info.lastScreen = containment->lastScreen();
+
+    //! the applets may not be restored yet, appletAdded follows for them
+    foreach (auto applet, containment->applets()) {
+        info.applets[applet->id()] = applet->kPackage().metadata().pluginId();
+    }
+
+    updateTasksPlasmoid(info);
+
+    connect(containment, &Plasma::Containment::appletAdded, this, [this, id](Plasma::Applet * applet) {
+        if (m_entries.contains(id)) {
+            ContainmentInfo &info = m_entries[id];
+            info.applets[applet->id()] = applet->kPackage().metadata().pluginId();
+            updateTasksPlasmoid(info);
+        }
+    });
+    connect(containment, &Plasma::Containment::appletRemoved, this, [this, id](Plasma::Applet * applet) {
+        if (m_entries.contains(id)) {
+            ContainmentInfo &info = m_entries[id];
+            info.applets.remove(applet->id());
+            updateTasksPlasmoid(info);
+        }
+    });
+    connect(containment, &Plasma::Containment::locationChanged, this, [this, id](Plasma::Types::Location location) {
+        if (m_entries.contains(id)) {
+            m_entries[id].location = location;
+        }
+    });
+    connect(containment, &Plasma::Containment::screenChanged, this, [this, id](int screen) {
+        if (m_entries.contains(id)) {
+            ContainmentInfo &info = m_entries[id];
+            info.screen = screen;
+
+            if (screen >= 0) {
+                info.lastScreen = screen;
+            }
+        }
+    });
+    connect(containment, &QObject::destroyed, this, [this, id]() {
+        m_entries.remove(id);
+    });
+}
+
+void ContainmentIndex::updateConfig(Plasma::Containment *containment)
+{
+    if (!containment || !m_entries.contains(containment->id())) {
+        return;
+    }
+
+    readConfig(m_entries[containment->id()], containment->config());
+    m_entries[containment->id()].lastScreen = containment->lastScreen();
+}
+
+bool ContainmentIndex::contains(uint id) const
+{
+    return m_entries.contains(id);
+}
+
+bool ContainmentIndex::isRunning(uint id) const
+{
+    return containment(id) != nullptr;
+}
+
+bool ContainmentIndex::hasApplet(uint containmentId, uint appletId) const
+{
+    auto it = m_entries.constFind(containmentId);
+
+    return it != m_entries.constEnd() && it->applets.contains(appletId);
+}
+
+bool ContainmentIndex::hasTasksPlasmoid(uint id) const
+{
+    auto it = m_entries.constFind(id);
+
+    return it != m_entries.constEnd() && it->hasTasksPlasmoid;
+}
+
+ContainmentInfo ContainmentIndex::info(uint id) const
+{
+    return m_entries.value(id);
+}
+
+Plasma::Containment *ContainmentIndex::containment(uint id) const
+{
+    auto it = m_entries.constFind(id);
+
+    return it != m_entries.constEnd() ? it->containment.data() : nullptr;
+}
+
+QList<uint> ContainmentIndex::ids() const
+{
+    QList<uint> result = m_entries.keys();
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+int ContainmentIndex::runningCount(Dock::SessionType session) const
+{
+    int count{0};
+
+    foreach (const ContainmentInfo &info, m_entries) {
+        if (info.containment && info.plugin == LatteContainment && info.session == session) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTAINMENTINDEX_H
+#define CONTAINMENTINDEX_H
+
+#include "../liblattedock/dock.h"
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+
+#include <KConfigGroup>
+
+#include <Plasma>
+#include <Plasma/Containment>
+
+namespace Latte {
+
+struct ContainmentInfo {
+    uint id{0};
+    QString plugin;
+    int screen{ -1};
+    int lastScreen{ -1};
+    bool onPrimary{true};
+    Plasma::Types::Location location{Plasma::Types::BottomEdge};
+    Dock::SessionType session{Dock::DefaultSession};
+    bool hasTasksPlasmoid{false};
+    //! applet id -> applet plugin
+    QHash<uint, QString> applets;
+    //! null for the containments that are only found in the configuration
+    QPointer<Plasma::Containment> containment;
+};
+
+/**
+ * @brief The ContainmentIndex class, the metadata of all the containments
+ * that DockCorona queries frequently.
+ *
+ * It is filled from the Containments configuration group once at startup and
+ * then it follows the running containments through their signals, so the
+ * queries do not have to walk the configuration groups or containments().
+ */
+class ContainmentIndex : public QObject {
+    Q_OBJECT
+
+public:
+    ContainmentIndex(QObject *parent = nullptr);
+    ~ContainmentIndex() override;
+
+    //! reads the Containments group, the previous entries are dropped
+    void load(const KConfigGroup &containments);
+    //! reads the entries from the layout cache of that configuration
+    //! file, false when the cache is missing or stale
+    bool loadCache(const QString &configFile);
+    bool saveCache(const QString &configFile) const;
+
+    //! starts following a running containment
+    void track(Plasma::Containment *containment);
+    //! re-reads the entries that Latte writes in the containment configuration
+    void updateConfig(Plasma::Containment *containment);
+
+    bool contains(uint id) const;
+    bool isRunning(uint id) const;
+    bool hasApplet(uint containmentId, uint appletId) const;
+    bool hasTasksPlasmoid(uint id) const;
+
+    //! a default ContainmentInfo when the id is not known
+    ContainmentInfo info(uint id) const;
+    Plasma::Containment *containment(uint id) const;
+
+    //! the known ids in ascending order
+    QList<uint> ids() const;
+    //! the running dock containments of that session
+    int runningCount(Dock::SessionType session) const;
+
+private:
+    void readConfig(ContainmentInfo &info, const KConfigGroup &group) const;
+    void updateTasksPlasmoid(ContainmentInfo &info) const;
+
+    QHash<uint, ContainmentInfo> m_entries;
+};
+
+}
+
+#endif // CONTAINMENTINDEX_H
@@ -19,20 +19,34 @@
 */
 
 #include "dockcorona.h"
+#include "containmentindex.h"
+#include "dockloader.h"
+#include "docksnapshots.h"
 #include "dockview.h"
+#include "dockplacement.h"
+#include "launcherentrylistener.h"
 #include "packageplugins/shell/dockpackage.h"
+#include "qmlprecompiler.h"
 #include "abstractwindowinterface.h"
 #include "alternativeshelper.h"
 #include "screenpool.h"
+#include "taskmanagerregistry.h"
 //dbus adaptor
 #include "lattedockadaptor.h"
+#include "../liblattedock/handoffproperties.h"
+#include "../liblattedock/startuptrace.h"
 
 #include <QAction>
 #include <QApplication>
 #include <QScreen>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QtMath>
 #include <QDBusConnection>
+#include <QDBusMetaType>
 #include <QDebug>
-#include <QDesktopWidget>
+#include <QDir>
+#include <QFile>
 #include <QFontDatabase>
 #include <QQmlContext>
 
@@ -49,18 +63,58 @@
 #include <KAboutData>
 #include <KActivities/Consumer>
 
+#include <unistd.h>
+
 namespace Latte {
 
-DockCorona::DockCorona(QObject *parent)
+int residentMemory()
+{
+    QFile statm(QStringLiteral("/proc/self/statm"));
+
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+
+    if (fields.count() < 2) {
+        return 0;
+    }
+
+    return static_cast<int>(fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) / 1024);
+}
+
+DockCorona::DockCorona(const QVariantMap &handoffState, QObject *parent)
     : Plasma::Corona(parent),
       m_activityConsumer(new KActivities::Consumer(this)),
       m_screenPool(new ScreenPool(KSharedConfig::openConfig(), this)),
+      m_containmentIndex(new ContainmentIndex(this)),
+      m_dockLoader(new DockLoader(this)),
+      m_dockSnapshots(new DockSnapshots(this)),
+      m_taskManagerRegistry(new TaskManagerRegistry(this)),
+      m_dockItemUpdates(new DockItemUpdateQueue(m_taskManagerRegistry, this)),
       m_globalSettings(new GlobalSettings(this))
 {
+    setHandoffState(handoffState);
     KPackage::Package package(new DockPackage(this));
     m_screenPool->load();
+    //! the docks of the last session are shown until their views are ready
+    m_dockSnapshots->show();
     m_globalSettings->load();
 
+    m_launcherEntries = new LauncherEntryListener(m_dockItemUpdates, this);
+    m_launcherEntries->setProgressRate(m_globalSettings->launcherEntryRate());
+    connect(m_globalSettings, &GlobalSettings::launcherEntryRateChanged, this, [this]() {
+        m_launcherEntries->setProgressRate(m_globalSettings->launcherEntryRate());
+    });
+    connect(m_globalSettings, &GlobalSettings::keepSessionsLoadedChanged, this, [this]() {
+        if (m_globalSettings->keepSessionsLoaded()) {
+            warmStandbyDocks();
+        } else {
+            releaseStandbyDocks();
+        }
+    });
+
     if (!package.isValid()) {
         qWarning() << staticMetaObject.className()
                    << "the package" << package.metadata().rawData() << "is invalid!";
@@ -74,7 +128,29 @@ DockCorona::DockCorona(QObject *parent)
     qmlRegisterTypes();
     QFontDatabase::addApplicationFont(kPackage().filePath("tangerineFont"));
 
-    connect(this, &Corona::containmentAdded, this, &DockCorona::addDock);
+    //! the index must follow the containment before addDock queries it
+    connect(this, &Corona::containmentAdded, m_containmentIndex, &ContainmentIndex::track);
+    connect(m_dockLoader, &DockLoader::finished, this, &DockCorona::precompileQml);
+    connect(m_dockLoader, &DockLoader::finished, this, &DockCorona::docksLoaded);
+    connect(m_dockLoader, &DockLoader::firstDockVisible, this, &DockCorona::firstDockVisible);
+    connect(m_dockLoader, &DockLoader::dockVisible, this, [this](DockView *view) {
+        if (view->containment()) {
+            m_dockSnapshots->dockReady(view->containment()->id());
+        }
+    });
+    connect(m_dockLoader, &DockLoader::finished, this, [this]() {
+        //! the docks that were not created, their snapshots must not stay
+        QTimer::singleShot(1000, m_dockSnapshots, &DockSnapshots::hideAll);
+    });
+    connect(this, &Corona::containmentAdded, this, [this](Plasma::Containment *containment) {
+        if (m_dockLoader->isHolding()) {
+            m_dockLoader->enqueue(containment);
+        } else {
+            addDock(containment);
+        }
+    });
+
+    m_activitiesWaitBegin = StartupTrace::now();
 
     if (m_activityConsumer && (m_activityConsumer->serviceStatus() == KActivities::Consumer::Running)) {
         load();
@@ -82,10 +158,6 @@ DockCorona::DockCorona(QObject *parent)
 
     connect(m_activityConsumer, &KActivities::Consumer::serviceStatusChanged, this, &DockCorona::load);
 
-    m_docksScreenSyncTimer.setSingleShot(true);
-    m_docksScreenSyncTimer.setInterval(2500);
-    connect(&m_docksScreenSyncTimer, &QTimer::timeout, this, &DockCorona::syncDockViews);
-
     KActionCollection *taskbarActions = new KActionCollection(this);
 
     //activate actions
@@ -117,6 +189,8 @@ DockCorona::DockCorona(QObject *parent)
     }
 
     //! Dbus adaptor initialization
+    qDBusRegisterMetaType<Latte::DockItemUpdate>();
+    qDBusRegisterMetaType<Latte::DockItemUpdates>();
     new LatteDockAdaptor(this);
     QDBusConnection dbus = QDBusConnection::sessionBus();
     dbus.registerObject(QStringLiteral("/Latte"), this);
@@ -124,8 +198,9 @@ DockCorona::DockCorona(QObject *parent)
 
 DockCorona::~DockCorona()
 {
-    m_docksScreenSyncTimer.stop();
-    cleanConfig();
+    if (!m_handedOff) {
+        saveState(true);
+    }
 
     while (!containments().isEmpty()) {
         //deleting a containment will remove it from the list due to QObject::destroyed connect in Corona
@@ -135,29 +210,124 @@ DockCorona::~DockCorona()
     m_globalSettings->deleteLater();
     qDeleteAll(m_dockViews);
     qDeleteAll(m_waitingDockViews);
+    qDeleteAll(m_standbyDockViews);
     m_dockViews.clear();
     m_waitingDockViews.clear();
+    m_standbyDockViews.clear();
     disconnect(m_activityConsumer, &KActivities::Consumer::serviceStatusChanged, this, &DockCorona::load);
     delete m_activityConsumer;
     qDebug() << "deleted" << this;
 }
 
+void DockCorona::saveState(bool snapshots)
+{
+    if (snapshots) {
+        //! only the docks of the default session are loaded at startup
+        QList<DockView *> defaultDocks;
+
+        for (const auto view : m_dockViews) {
+            if (view->session() == Dock::DefaultSession) {
+                defaultDocks << view;
+            }
+        }
+
+        m_dockSnapshots->save(defaultDocks);
+    }
+
+    cleanConfig();
+
+    //! the cache of the next startup is created from the cleaned configuration
+    config()->sync();
+    ContainmentIndex layout;
+    layout.load(config()->group("Containments"));
+    layout.saveCache(layoutConfigFile());
+}
+
+void DockCorona::prepareHandoff()
+{
+    saveState(true);
+    m_handedOff = true;
+}
+
+void DockCorona::resumeAfterHandoff()
+{
+    m_handedOff = false;
+}
+
+QVariantMap DockCorona::handoffState() const
+{
+    QVariantMap docks;
+
+    for (const auto view : m_dockViews) {
+        if (!view->containment() || !view->visibility())
+            continue;
+
+        docks[QString::number(view->containment()->id())] = QVariantMap{
+            {QStringLiteral("geometry"), view->absGeometry()},
+            {QStringLiteral("hidden"), view->visibility()->isHidden()}
+        };
+    }
+
+    QVariantList colors;
+
+    if (QObject *iconColors = qApp->property(IconColorsProperty).value<QObject *>()) {
+        QMetaObject::invokeMethod(iconColors, "exportColors", Q_RETURN_ARG(QVariantList, colors));
+    }
+
+    return QVariantMap{
+        {QStringLiteral("docks"), docks},
+        {QStringLiteral("iconColors"), colors}
+    };
+}
+
+void DockCorona::setHandoffState(const QVariantMap &state)
+{
+    m_handoffDocks = state.value(QStringLiteral("docks")).toMap();
+
+    //! the icon colors are imported when the plugin creates its cache
+    const QVariantList colors = state.value(QStringLiteral("iconColors")).toList();
+
+    if (!colors.isEmpty()) {
+        qApp->setProperty(HandoffIconColorsProperty, colors);
+    }
+}
+
 void DockCorona::load()
 {
     if (m_activityConsumer && (m_activityConsumer->serviceStatus() == KActivities::Consumer::Running) && m_activitiesStarting) {
         disconnect(m_activityConsumer, &KActivities::Consumer::serviceStatusChanged, this, &DockCorona::load);
 
         m_activitiesStarting = false;
+        StartupTrace::complete("KActivities::Consumer wait", m_activitiesWaitBegin);
+
+        //! the configuration is walked only when the layout cache is stale
+        const QString configFile = layoutConfigFile();
+
+        if (!m_containmentIndex->loadCache(configFile)) {
+            m_containmentIndex->load(config()->group("Containments"));
+            m_containmentIndex->saveCache(configFile);
+        }
+
         m_tasksWillBeLoaded =  heuresticForLoadingDockWithTasks();
         qDebug() << "TASKS WILL BE PRESENT AFTER LOADING ::: " << m_tasksWillBeLoaded;
 
         //  connect(qGuiApp, &QGuiApplication::screenAdded, this, &DockCorona::addOutput, Qt::UniqueConnection);
         connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &DockCorona::primaryOutputChanged, Qt::UniqueConnection);
         //  connect(qGuiApp, &QGuiApplication::screenRemoved, this, &DockCorona::screenRemoved, Qt::UniqueConnection);
-        connect(QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &DockCorona::screenCountChanged);
-        connect(m_screenPool, &ScreenPool::primaryPoolChanged, this, &DockCorona::screenCountChanged);
+        //! the topology changes are already debounced by the screen pool
+        connect(m_screenPool, &ScreenPool::topologyChanged, this, &DockCorona::syncDockViews);
 
+        //! the docks of the layout are created by the loader in priority order
+        m_dockLoader->hold();
+        StartupTrace::Span layoutSpan("DockCorona::loadLayout");
         loadLayout();
+        layoutSpan.finish();
+        m_dockLoader->start();
+
+        //! the other session is loaded after the startup has settled
+        if (m_globalSettings->keepSessionsLoaded()) {
+            QTimer::singleShot(3000, this, &DockCorona::warmStandbyDocks);
+        }
     }
 }
 
@@ -167,7 +337,7 @@ void DockCorona::cleanConfig()
     bool changed = false;
 
     foreach (auto cId, containmentsEntries.groupList()) {
-        if (!containmentExists(cId.toUInt())) {
+        if (!m_containmentIndex->isRunning(cId.toUInt())) {
             //cleanup obsolete containments
             containmentsEntries.group(cId).deleteGroup();
             changed = true;
@@ -177,7 +347,7 @@ void DockCorona::cleanConfig()
             auto appletsEntries = containmentsEntries.group(cId).group("Applets");
 
             foreach (auto appletId, appletsEntries.groupList()) {
-                if (!appletExists(cId.toUInt(), appletId.toUInt())) {
+                if (!m_containmentIndex->hasApplet(cId.toUInt(), appletId.toUInt())) {
                     appletsEntries.group(appletId).deleteGroup();
                     changed = true;
                     qDebug() << "obsolete applet configuration deleted:" << appletId;
@@ -192,39 +362,25 @@ void DockCorona::cleanConfig()
     }
 }
 
-bool DockCorona::containmentExists(uint id) const
+QString DockCorona::layoutConfigFile() const
 {
-    foreach (auto containment, containments()) {
-        if (id == containment->id()) {
-            return true;
-        }
+    const QString name = config()->name();
+
+    if (QDir::isAbsolutePath(name)) {
+        return name;
     }
 
-    return false;
+    return QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) + QLatin1Char('/') + name;
 }
 
-bool DockCorona::appletExists(uint containmentId, uint appletId) const
+Plasma::Containment *DockCorona::containmentById(uint id) const
 {
-    Plasma::Containment *containment = nullptr;
-
-    foreach (auto cont, containments()) {
-        if (containmentId == cont->id()) {
-            containment = cont;
-            break;
-        }
-    }
-
-    if (!containment) {
-        return false;
-    }
-
-    foreach (auto applet, containment->applets()) {
-        if (applet->id() == appletId) {
-            return true;
-        }
-    }
+    return m_containmentIndex->containment(id);
+}
 
-    return false;
+ContainmentIndex *DockCorona::containmentIndex() const
+{
+    return m_containmentIndex;
 }
 
 ScreenPool *DockCorona::screenPool() const
@@ -244,40 +400,20 @@ int DockCorona::numScreens() const
 
 QRect DockCorona::screenGeometry(int id) const
 {
-    const auto screens = qGuiApp->screens();
-    const QScreen *screen{qGuiApp->primaryScreen()};
+    const QScreen *screen = m_screenPool->screen(id);
 
-    QString screenName;
-
-    if (m_screenPool->knownIds().contains(id))
-        screenName = m_screenPool->connector(id);
-
-    foreach (auto scr, screens) {
-        if (scr->name() == screenName) {
-            screen = scr;
-            break;
-        }
-    }
+    if (!screen)
+        screen = qGuiApp->primaryScreen();
 
     return screen->geometry();
 }
 
 QRegion DockCorona::availableScreenRegion(int id) const
 {
-    const auto screens = qGuiApp->screens();
-    const QScreen *screen{qGuiApp->primaryScreen()};
-
-    QString screenName;
+    const QScreen *screen = m_screenPool->screen(id);
 
-    if (m_screenPool->knownIds().contains(id))
-        screenName = m_screenPool->connector(id);
-
-    foreach (auto scr, screens) {
-        if (scr->name() == screenName) {
-            screen = scr;
-            break;
-        }
-    }
+    if (!screen)
+        screen = qGuiApp->primaryScreen();
 
     if (!screen)
         return QRegion();
@@ -370,19 +506,10 @@ QRegion DockCorona::availableScreenRegion(int id) const
 
 QRect DockCorona::availableScreenRect(int id) const
 {
-    const auto screens = qGuiApp->screens();
-    const QScreen *screen{qGuiApp->primaryScreen()};
-
-    if (m_screenPool->knownIds().contains(id)) {
-        QString scrName = m_screenPool->connector(id);
+    const QScreen *screen = m_screenPool->screen(id);
 
-        foreach (auto scr, screens) {
-            if (scr->name() == scrName) {
-                screen = scr;
-                break;
-            }
-        }
-    }
+    if (!screen)
+        screen = qGuiApp->primaryScreen();
 
     if (!screen)
         return {};
@@ -458,132 +585,119 @@ void DockCorona::screenRemoved(QScreen *screen)
     Q_ASSERT(screen);
 }
 
-void DockCorona::screenCountChanged()
-{
-    m_docksScreenSyncTimer.start();
-}
-
 //! the central functions that updates loading/unloading dockviews
 //! concerning screen changed (for multi-screen setups mainly)
+//! the dock model is collected once and DockPlacement decides in one pass
+//! which docks must be deleted, moved or created
 void DockCorona::syncDockViews()
 {
-    qDebug() << "screen count changed -+-+ " << qGuiApp->screens().size();
+    LATTE_TRACE_SCOPE("DockCorona::syncDockViews");
 
-    qDebug() << "adding consideration....";
+    qDebug() << "screen count changed -+-+ " << qGuiApp->screens().size();
     qDebug() << "dock view running : " << m_dockViews.count();
 
-    foreach (auto scr, qGuiApp->screens()) {
-        qDebug() << "Found screen: " << scr->name();
+    DockPlacement::Topology topology;
+
+    for (QScreen *scr : qGuiApp->screens()) {
+        topology.screens << scr->name();
+    }
+
+    topology.primary = qGuiApp->primaryScreen() ? qGuiApp->primaryScreen()->name() : QString();
 
-        foreach (auto cont, containments()) {
+    QList<DockPlacement::DockState> docks;
+    QHash<uint, Plasma::Containment *> containmentForId;
+
+    foreach (auto cont, containments()) {
+        const ContainmentInfo info = m_containmentIndex->info(cont->id());
+
+        //! e.g. the systrays of the docks, they must not take an edge
+        if (info.plugin != QLatin1String("org.kde.latte.containment")) {
+            continue;
+        }
+
+        DockPlacement::DockState dock;
+        dock.id = cont->id();
+
+        if (DockView *view = m_dockViews.value(cont)) {
+            dock.running = true;
+            dock.screen = view->screen() ? view->screen()->name() : QString();
+            dock.explicitScreen = view->currentScreen();
+            dock.onPrimary = view->onPrimary();
+            dock.hasTasks = view->tasksPresent();
+            dock.location = view->location();
+            dock.session = view->session();
+        } else {
             int id = cont->screen();
 
             if (id == -1) {
                 id = cont->lastScreen();
             }
 
-            bool onPrimary = cont->config().readEntry("onPrimary", true);
-            Plasma::Types::Location location = static_cast<Plasma::Types::Location>((int)cont->config().readEntry("location", (int)Plasma::Types::BottomEdge));
-            Dock::SessionType session = static_cast<Dock::SessionType>((int)cont->config().readEntry("session", (int)Dock::DefaultSession));
-
-            //! two main situations that a dock must be added when it is not already running
-            //! 1. when a dock is primary, not running and the edge for which is associated is free
-            //! 2. when a dock in explicit, not running and the associated screen currently exists
-            //! e.g. the screen has just been added
-            if (((onPrimary && freeEdges(qGuiApp->primaryScreen()).contains(location)) || (!onPrimary && (m_screenPool->connector(id) == scr->name())))
-                && (!m_dockViews.contains(cont)) && session == currentSession()) {
-                qDebug() << "screen Count signal: view must be added... for:" << scr->name();
-                addDock(cont);
+            if (m_screenPool->isKnownId(id)) {
+                dock.explicitScreen = m_screenPool->connector(id);
             }
+
+            dock.onPrimary = info.onPrimary;
+            dock.location = info.location;
+            dock.session = info.session;
         }
+
+        containmentForId[dock.id] = cont;
+        docks << dock;
     }
 
-    qDebug() << "removing consideration & updating screen for always on primary docks....";
+    const auto actions = DockPlacement::plan(topology, docks, currentSession());
 
-    //! this code trys to find a containment that must not be deleted by
-    //! automatic algorithm. Currently the containment with the minimum id
-    //! containing tasks plasmoid wins
-    int preserveContainmentId{ -1};
-    bool dockWithTasksWillBeShown{false};
+    foreach (const auto &action, actions) {
+        Plasma::Containment *cont = containmentForId.value(action.id);
 
-    //! associate correct values for preserveContainmentId and
-    //! dockWithTasksWillBeShown
-    foreach (auto view, m_dockViews) {
-        bool found{false};
+        switch (action.type) {
+            case DockPlacement::DeleteDock: {
+                qDebug() << "screen topology: view must be deleted... for:" << action.id;
+                auto viewToDelete = m_dockViews.take(cont);
+                removeDockEdge(viewToDelete);
 
-        foreach (auto scr, qGuiApp->screens()) {
-            int id = view->containment()->screen();
+                if (viewToDelete->session() != currentSession()) {
+                    viewToDelete->deactivateApplets();
 
-            if (id == -1) {
-                id = view->containment()->lastScreen();
-            }
+                    if (m_globalSettings->keepSessionsLoaded()) {
+                        parkDock(cont, viewToDelete);
+                        break;
+                    }
+                }
 
-            if (scr->name() == view->currentScreen()) {
-                found = true;
+                viewToDelete->deleteLater();
                 break;
             }
-        }
-
-        //!check if a tasks dock will be shown (try to prevent its deletion)
-        if (found && view->tasksPresent()) {
-            dockWithTasksWillBeShown = true;
-        }
 
-        if (!found && !view->onPrimary() && (m_dockViews.size() > 1) && m_dockViews.contains(view->containment())
-            && !(view->tasksPresent() && noDocksWithTasks() == 1)) { //do not delete last dock containing tasks
-            if (view->tasksPresent()) {
-                if (preserveContainmentId == -1)
-                    preserveContainmentId = view->containment()->id();
-                else if (view->containment()->id() < preserveContainmentId)
-                    preserveContainmentId = view->containment()->id();
-            }
-        }
-    }
+            case DockPlacement::MoveDock: {
+                qDebug() << "screen topology: view must be moved... for:" << action.id << "to:" << action.screen;
+                DockView *view = m_dockViews.value(cont);
+                QScreen *scr = m_screenPool->screen(action.screen);
 
-    //! check which docks must be deleted e.g. when the corresponding
-    //! screen does not exist any more.
-    //! The code is smart enough in order
-    //! to never delete the last tasks dock and also it makes sure that
-    //! the last tasks dock which will exist in the end will be the one
-    //! with the lowest containment id
-    foreach (auto view, m_dockViews) {
-        bool found{false};
+                if (view && scr) {
+                    connect(scr, &QScreen::geometryChanged, view, &DockView::screenGeometryChanged, Qt::UniqueConnection);
+                    view->setScreenToFollow(scr, action.updateScreenId);
+                }
 
-        foreach (auto scr, qGuiApp->screens()) {
-            if (scr->name() == view->currentScreen()) {
-                found = true;
                 break;
             }
-        }
 
-        if (view->session() != currentSession()) {
-            qDebug() << "deleting view that does not belong in this session...";
-            auto viewToDelete = m_dockViews.take(view->containment());
-            viewToDelete->deactivateApplets();
-            viewToDelete->deleteLater();
-            //! which explicit docks can be deleted
-        } else if (!found && !view->onPrimary() && (m_dockViews.size() > 1) && m_dockViews.contains(view->containment())
-                   && !(view->tasksPresent() && noDocksWithTasks() == 1)) {
-            //do not delete last dock containing tasks
-            if (dockWithTasksWillBeShown || preserveContainmentId != view->containment()->id()) {
-                qDebug() << "screen Count signal: view must be deleted... for:" << view->currentScreen();
-                auto viewToDelete = m_dockViews.take(view->containment());
-                viewToDelete->deleteLater();
-            }
+            case DockPlacement::CreateDock:
+                qDebug() << "screen topology: view must be added... for:" << action.id << "at:" << action.screen;
 
-            //!which primary docks can be deleted
-        } else if (view->onPrimary() && !found
-                   && !freeEdges(qGuiApp->primaryScreen()).contains(view->location())) {
-            qDebug() << "screen Count signal: primary view must be deleted... for:" << view->currentScreen();
-            auto viewToDelete = m_dockViews.take(view->containment());
-            viewToDelete->deleteLater();
-        } else {
-            //! if the dock will not be deleted its a very good point to reconsider
-            //! if the screen in which is running is the correct one
-            view->reconsiderScreen();
+                if (!restoreStandbyDock(cont, action.screen, action.updateScreenId)) {
+                    addDock(cont);
+                }
+
+                break;
         }
     }
 
+    if (!actions.isEmpty()) {
+        emit docksCountChanged();
+    }
+
     qDebug() << "end of screens count change....";
 }
 
@@ -660,8 +774,10 @@ void DockCorona::setCurrentSession(Dock::SessionType session)
     }
 
     m_session = session;
+    rebuildEdgeOccupancy();
 
-    emit currentSessionChanged(m_session);;
+    emit currentSessionChanged(m_session);
+    emit standbyMemoryCostChanged();
 }
 
 void DockCorona::switchToSession(Dock::SessionType session)
@@ -682,51 +798,108 @@ void DockCorona::switchToSession(Dock::SessionType session)
 }
 int DockCorona::noDocksForSession(Dock::SessionType session)
 {
-    int count{0};
+    return m_containmentIndex->runningCount(session);
+}
 
-    foreach (auto cont, containments()) {
-        Dock::SessionType ses = static_cast<Dock::SessionType>(cont->config().readEntry("session", (int)Dock::DefaultSession));
+QList<Plasma::Types::Location> DockCorona::freeEdges(QScreen *screen) const
+{
+    return freeEdges(screen ? screen->name() : QString());
+}
 
-        if (session == ses)
-            count++;
-    }
+QList<Plasma::Types::Location> DockCorona::freeEdges(int screen) const
+{
+    //when screen=-1 is passed then the primaryScreenid is used
+    int fixedScreen = (screen == -1) ? primaryScreenId() : screen;
 
-    return count;
+    return freeEdges(m_screenPool->isKnownId(fixedScreen) ? m_screenPool->connector(fixedScreen) : QString());
 }
 
-QList<Plasma::Types::Location> DockCorona::freeEdges(QScreen *screen) const
+QList<Plasma::Types::Location> DockCorona::freeEdges(const QString &connector) const
 {
     using Plasma::Types;
-    QList<Types::Location> edges{Types::BottomEdge, Types::LeftEdge,
-                                 Types::TopEdge, Types::RightEdge};
+    QList<Types::Location> edges;
+    const auto occupancy = m_edgeOccupancy.value(connector);
 
-    for (auto *view : m_dockViews) {
-        if (view && view->currentScreen() == screen->name() && view->session() == m_session) {
-            edges.removeOne(view->location());
+    for (auto edge : {Types::BottomEdge, Types::LeftEdge, Types::TopEdge, Types::RightEdge}) {
+        if (occupancy[edge - Types::TopEdge] == 0) {
+            edges << edge;
         }
     }
 
     return edges;
 }
 
-QList<Plasma::Types::Location> DockCorona::freeEdges(int screen) const
+//!BEGIN edge occupancy
+//! every dock of the current session takes one slot at the edge of its
+//! screen, the table is updated when a dock is added/removed or changes
+//! its screen, location or session so the edge queries are just lookups
+void DockCorona::updateDockEdge(DockView *view)
 {
-    using Plasma::Types;
-    QList<Types::Location> edges{Types::BottomEdge, Types::LeftEdge,
-                                 Types::TopEdge, Types::RightEdge};
-    //when screen=-1 is passed then the primaryScreenid is used
-    int fixedScreen = (screen == -1) ? primaryScreenId() : screen;
+    removeDockEdge(view);
+
+    if (!view || !view->containment() || view->session() != m_session
+        || m_dockViews.value(view->containment()) != view) {
+        return;
+    }
+
+    const Plasma::Types::Location location = view->location();
+
+    if (location < Plasma::Types::TopEdge || location > Plasma::Types::RightEdge) {
+        return;
+    }
+
+    const QString connector = view->currentScreen();
+    m_dockEdges[view] = qMakePair(connector, location);
+    ++m_edgeOccupancy[connector][location - Plasma::Types::TopEdge];
+
+    emit freeEdgesChanged(connector);
+}
+
+void DockCorona::removeDockEdge(const DockView *view)
+{
+    if (!m_dockEdges.contains(view)) {
+        return;
+    }
+
+    const auto edge = m_dockEdges.take(view);
+    auto &occupancy = m_edgeOccupancy[edge.first];
+    --occupancy[edge.second - Plasma::Types::TopEdge];
+
+    if (occupancy == EdgeSlots{{0, 0, 0, 0}}) {
+        m_edgeOccupancy.remove(edge.first);
+    }
+
+    emit freeEdgesChanged(edge.first);
+}
+
+void DockCorona::rebuildEdgeOccupancy()
+{
+    QSet<QString> screens;
+
+    for (auto it = m_dockEdges.constBegin(); it != m_dockEdges.constEnd(); ++it) {
+        screens << it.value().first;
+    }
+
+    m_dockEdges.clear();
+    m_edgeOccupancy.clear();
+
+    const QSignalBlocker blocker(this);
 
     for (auto *view : m_dockViews) {
-        if (view && view->containment()
-            && view->containment()->screen() == fixedScreen
-            && view->session() == m_session) {
-            edges.removeOne(view->location());
-        }
+        updateDockEdge(view);
     }
 
-    return edges;
+    for (auto it = m_dockEdges.constBegin(); it != m_dockEdges.constEnd(); ++it) {
+        screens << it.value().first;
+    }
+
+    blocker.unblock();
+
+    foreach (const QString &screen, screens) {
+        emit freeEdgesChanged(screen);
+    }
 }
+//!END edge occupancy
 
 int DockCorona::screenForContainment(const Plasma::Containment *containment) const
 {
@@ -764,20 +937,202 @@ int DockCorona::screenForContainment(const Plasma::Containment *containment) con
     //won't be associated to a screen
     //     qDebug() << "ShellCorona screenForContainment: " << containment << " Last screen is " << containment->lastScreen();
 
-    for (auto screen : qGuiApp->screens()) {
-        // containment->lastScreen() == m_screenPool->id(screen->name()) to check if the lastScreen refers to a screen that exists/it's known
-        if (containment->lastScreen() == m_screenPool->id(screen->name()) &&
-            (containment->activity() == m_activityConsumer->currentActivity() ||
-             containment->containmentType() == Plasma::Types::PanelContainment || containment->containmentType() == Plasma::Types::CustomPanelContainment)) {
-            return containment->lastScreen();
-        }
+    // m_screenPool->screen(containment->lastScreen()) to check if the lastScreen refers to a screen that exists/it's known
+    if (m_screenPool->screen(containment->lastScreen()) &&
+        (containment->activity() == m_activityConsumer->currentActivity() ||
+         containment->containmentType() == Plasma::Types::PanelContainment || containment->containmentType() == Plasma::Types::CustomPanelContainment)) {
+        return containment->lastScreen();
     }
 
     return -1;
 }
 
+void DockCorona::updateLauncherEntryProgressLength()
+{
+    int thickness{0};
+
+    for (const auto view : m_dockViews) {
+        thickness = qMax(thickness, view->maxThickness());
+    }
+
+    //! the circle is 0.4 of the icon size, the zoomed thickness
+    //! is used so that no visible step is ever skipped
+    if (thickness > 0) {
+        m_launcherEntries->setProgressLength(qCeil(M_PI * 0.4 * thickness));
+    }
+}
+
+void DockCorona::precompileQml()
+{
+    if (m_qmlPrecompiler || m_dockViews.isEmpty()) {
+        return;
+    }
+
+    //! all the dock views share the same engine
+    m_qmlPrecompiler = new QmlPrecompiler(m_dockViews.begin().value()->engine(), this);
+
+    QStringList packages{kPackage().path()};
+
+    for (const auto &plugin : {QStringLiteral("org.kde.latte.containment"), QStringLiteral("org.kde.latte.plasmoid")}) {
+        const auto package = KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/Applet"), plugin);
+
+        if (package.isValid()) {
+            packages << package.path();
+        }
+    }
+
+    m_qmlPrecompiler->start(packages);
+}
+
+//!BEGIN standby docks
+//! a hidden window is not exposed so the scene graph does not render it,
+//! its applets and QML stay loaded and showing it again is immediate
+void DockCorona::parkDock(Plasma::Containment *containment, DockView *view)
+{
+    qDebug() << "dock is kept on standby... for:" << containment->id();
+
+    view->setMapped(false);
+    m_standbyDockViews[containment] = view;
+
+    emit standbyMemoryCostChanged();
+}
+
+bool DockCorona::restoreStandbyDock(Plasma::Containment *containment, const QString &connector, bool updateScreenId)
+{
+    DockView *view = m_standbyDockViews.take(containment);
+
+    if (!view) {
+        return false;
+    }
+
+    qDebug() << "dock is restored from standby... for:" << containment->id() << "at:" << connector;
+
+    if (QScreen *scr = m_screenPool->screen(connector)) {
+        connect(scr, &QScreen::geometryChanged, view, &DockView::screenGeometryChanged, Qt::UniqueConnection);
+        view->setScreenToFollow(scr, updateScreenId);
+    }
+
+    view->setMapped(true);
+    m_dockViews[containment] = view;
+    updateDockEdge(view);
+    updateLauncherEntryProgressLength();
+
+    emit standbyMemoryCostChanged();
+
+    return true;
+}
+
+void DockCorona::warmStandbyDocks()
+{
+    if (!m_globalSettings->keepSessionsLoaded() || m_activitiesStarting) {
+        return;
+    }
+
+    m_warmingStandbyDocks = true;
+
+    foreach (auto cont, containments()) {
+        const ContainmentInfo info = m_containmentIndex->info(cont->id());
+
+        if (info.plugin == QLatin1String("org.kde.latte.containment") && info.session != currentSession()) {
+            addDock(cont);
+        }
+    }
+
+    m_warmingStandbyDocks = false;
+
+    emit standbyMemoryCostChanged();
+}
+
+void DockCorona::releaseStandbyDocks()
+{
+    for (auto view : m_standbyDockViews) {
+        view->deleteLater();
+    }
+
+    m_standbyDockViews.clear();
+
+    emit standbyMemoryCostChanged();
+}
+
+//! the ui of the dock is incubated after addDock returns, its cost is
+//! read when the ui is ready and, for a shown dock, has been rendered
+void DockCorona::measureDockMemory(DockView *view)
+{
+    if (!view->isUiReady()) {
+        connect(view, &DockView::uiReady, this, [this, view]() {
+            disconnect(view, &DockView::uiReady, this, nullptr);
+            measureDockMemory(view);
+        });
+        return;
+    }
+
+    if (!view->isVisible()) {
+        finishDockMemory(view);
+        return;
+    }
+
+    connect(view, &QQuickWindow::frameSwapped, this, [this, view]() {
+        disconnect(view, &QQuickWindow::frameSwapped, this, nullptr);
+        finishDockMemory(view);
+    });
+}
+
+void DockCorona::finishDockMemory(DockView *view)
+{
+    if (!m_memoryMeasures.contains(view)) {
+        return;
+    }
+
+    const int memoryBefore = m_memoryMeasures.take(view);
+
+    if (memoryBefore > 0 && view->containment()) {
+        m_dockMemoryCost[view->containment()->id()] = qMax(0, residentMemory() - memoryBefore);
+        emit standbyMemoryCostChanged();
+    }
+}
+
+int DockCorona::standbyMemoryCost() const
+{
+    int cost{0};
+    int unknown{0};
+
+    for (uint id : m_containmentIndex->ids()) {
+        const ContainmentInfo info = m_containmentIndex->info(id);
+
+        if (info.plugin != QLatin1String("org.kde.latte.containment") || info.session == m_session) {
+            continue;
+        }
+
+        if (m_dockMemoryCost.contains(id)) {
+            cost += m_dockMemoryCost.value(id);
+        } else {
+            ++unknown;
+        }
+    }
+
+    //! the docks that were never created are estimated from the others
+    if (unknown > 0 && !m_dockMemoryCost.isEmpty()) {
+        int total{0};
+
+        for (int dockCost : m_dockMemoryCost) {
+            total += dockCost;
+        }
+
+        cost += unknown * (total / m_dockMemoryCost.count());
+    }
+
+    return cost;
+}
+//!END standby docks
+
 void DockCorona::addDock(Plasma::Containment *containment)
 {
+    StartupTrace::Span span("DockCorona::addDock");
+
+    if (span.isRecording() && containment) {
+        span.setDetail(QString::number(containment->id()));
+    }
+
     if (!containment || !containment->kPackage().isValid()) {
         qWarning() << "the requested containment plugin can not be located or loaded";
         return;
@@ -792,15 +1147,19 @@ void DockCorona::addDock(Plasma::Containment *containment)
     int session = containment->config().readEntry("session", (int)Dock::DefaultSession);
 
     //! when this containment does not belong to this session
-    if (session != currentSession() && !m_waitingSessionDocksCreation) {
+    if (session != currentSession() && !m_waitingSessionDocksCreation && !m_warmingStandbyDocks) {
         return;
     }
 
-    for (auto *dock : m_dockViews) {
-        if (dock->containment() == containment)
-            return;
+    //! the creation processes events, e.g. for the incubation, so the
+    //! same containment can be requested again before it is finished
+    if (m_dockViews.contains(containment) || m_standbyDockViews.contains(containment)
+        || m_creatingDocks.contains(containment)) {
+        return;
     }
 
+    const bool standby = m_warmingStandbyDocks && session != currentSession();
+
     QScreen *nextScreen{qGuiApp->primaryScreen()};
 
     //! forceDockLoading is used when a latte configuration based on the
@@ -809,7 +1168,7 @@ void DockCorona::addDock(Plasma::Containment *containment)
     //! and it forcefully becomes primary dock
     bool forceDockLoading = false;
 
-    if (!m_tasksWillBeLoaded && m_firstContainmentWithTasks == static_cast<int>(containment->id())) {
+    if (!standby && !m_tasksWillBeLoaded && m_firstContainmentWithTasks == static_cast<int>(containment->id())) {
         m_tasksWillBeLoaded = true; //this protects by loading more than one dock at startup
         forceDockLoading = true;
     }
@@ -826,20 +1185,14 @@ void DockCorona::addDock(Plasma::Containment *containment)
     if (id >= 0 && !onPrimary && !forceDockLoading) {
         QString connector = m_screenPool->connector(id);
         qDebug() << "add dock - connector : " << connector;
-        bool found{false};
-
-        foreach (auto scr, qGuiApp->screens()) {
-            if (scr && scr->name() == connector) {
-                found = true;
-                nextScreen = scr;
-                break;
-            }
-        }
+        QScreen *scr = m_screenPool->screen(connector);
 
-        if (!found) {
+        if (!scr) {
             qDebug() << "adding dock rejected, screen not available : " << connector;
             return;
         }
+
+        nextScreen = scr;
     }
 
     qDebug() << "Adding dock for container...";
@@ -857,9 +1210,31 @@ void DockCorona::addDock(Plasma::Containment *containment)
         dockWin = containment->config().readEntry("dockWindowBehavior", true);
     }
 
+    //! a cost is kept only when no other dock is created while this one
+    //! is, the resident memory can not be split between them
+    const int memoryBefore = m_memoryMeasures.isEmpty() ? residentMemory() : -1;
+
+    for (auto it = m_memoryMeasures.begin(); it != m_memoryMeasures.end(); ++it) {
+        it.value() = -1;
+    }
+
+    m_creatingDocks.insert(containment);
+
     auto dockView = new DockView(this, nextScreen, dockWin);
+    m_memoryMeasures[dockView] = memoryBefore;
+    m_dockLoader->prepare(dockView);
     dockView->init();
+    //! the applets of the containment are initialized here
+    StartupTrace::Span appletsSpan("DockView::setContainment");
     dockView->setContainment(containment);
+    appletsSpan.finish();
+
+    const QVariantMap handoffDock = m_handoffDocks.take(QString::number(containment->id())).toMap();
+
+    if (!handoffDock.isEmpty()) {
+        dockView->visibility()->applyHandoffState(handoffDock.value(QStringLiteral("hidden")).toBool()
+                                                  , handoffDock.value(QStringLiteral("geometry")).toRect());
+    }
 
     //! force this special dock case to become primary
     //! even though it isnt
@@ -867,16 +1242,54 @@ void DockCorona::addDock(Plasma::Containment *containment)
         dockView->setOnPrimary(true);
     }
 
-    dockView->setSession(currentSession());
+    dockView->setSession(standby ? static_cast<Dock::SessionType>(session) : currentSession());
+    m_containmentIndex->updateConfig(containment);
 
+    connect(dockView, &DockView::onPrimaryChanged, this, [this, containment]() {
+        m_containmentIndex->updateConfig(containment);
+    });
+    connect(dockView, &DockView::sessionChanged, this, [this, containment]() {
+        m_containmentIndex->updateConfig(containment);
+    });
     connect(containment, &QObject::destroyed, this, &DockCorona::dockContainmentDestroyed);
     connect(containment, &Plasma::Applet::destroyedChanged, this, &DockCorona::destroyedChanged);
     connect(containment, &Plasma::Applet::locationChanged, this, &DockCorona::dockLocationChanged);
     connect(containment, &Plasma::Containment::appletAlternativesRequested
             , this, &DockCorona::showAlternativesForApplet, Qt::QueuedConnection);
 
-    dockView->show();
+    connect(dockView, &DockView::currentScreenChanged, this, [this, dockView]() {
+        updateDockEdge(dockView);
+    });
+    connect(dockView, &DockView::locationChanged, this, [this, dockView]() {
+        updateDockEdge(dockView);
+    });
+    connect(dockView, &DockView::sessionChanged, this, [this, dockView]() {
+        updateDockEdge(dockView);
+    });
+    connect(dockView, &QObject::destroyed, this, [this, dockView]() {
+        removeDockEdge(dockView);
+    });
+    connect(dockView, &DockView::maxThicknessChanged, this, &DockCorona::updateLauncherEntryProgressLength);
+    connect(dockView, &QObject::destroyed, this, &DockCorona::updateLauncherEntryProgressLength, Qt::QueuedConnection);
+
+    connect(dockView, &QObject::destroyed, this, [this, dockView]() {
+        m_memoryMeasures.remove(dockView);
+    });
+
+    if (standby) {
+        parkDock(containment, dockView);
+        m_creatingDocks.remove(containment);
+        measureDockMemory(dockView);
+        return;
+    }
+
+    dockView->setMapped(true);
     m_dockViews[containment] = dockView;
+    m_creatingDocks.remove(containment);
+    measureDockMemory(dockView);
+    m_dockLoader->dockShown(dockView);
+    updateDockEdge(dockView);
+    updateLauncherEntryProgressLength();
 
     if (m_waitingSessionDocksCreation) {
         m_waitingSessionDocksCreation = false;
@@ -894,7 +1307,8 @@ void DockCorona::recreateDock(Plasma::Containment *containment)
     auto view = m_dockViews.take(containment);
 
     if (view) {
-        view->setVisible(false);
+        removeDockEdge(view);
+        view->setMapped(false);
         view->deleteLater();
         addDock(view->containment());
     }
@@ -911,8 +1325,10 @@ void DockCorona::destroyedChanged(bool destroyed)
 
     if (destroyed) {
         m_waitingDockViews[sender] = m_dockViews.take(static_cast<Plasma::Containment *>(sender));
+        removeDockEdge(m_waitingDockViews.value(sender));
     } else {
         m_dockViews[sender] = m_waitingDockViews.take(static_cast<Plasma::Containment *>(sender));
+        updateDockEdge(m_dockViews.value(sender));
     }
 
     emit docksCountChanged();
@@ -926,6 +1342,13 @@ void DockCorona::dockContainmentDestroyed(QObject *cont)
     if (view)
         delete view;
 
+    auto standbyView = m_standbyDockViews.take(static_cast<Plasma::Containment *>(cont));
+
+    if (standbyView) {
+        delete standbyView;
+        emit standbyMemoryCostChanged();
+    }
+
     emit docksCountChanged();
 }
 
@@ -1034,43 +1457,21 @@ void DockCorona::loadDefaultLayout()
 //! in it will be loaded taking into account also the screens are present.
 bool DockCorona::heuresticForLoadingDockWithTasks()
 {
-    auto containmentsEntries = config()->group("Containments");
-
-    foreach (auto cId, containmentsEntries.groupList()) {
-        QString plugin = containmentsEntries.group(cId).readEntry("plugin");
-
-        if (plugin == "org.kde.latte.containment") {
-            bool onPrimary = containmentsEntries.group(cId).readEntry("onPrimary", true);
-            int lastScreen = containmentsEntries.group(cId).readEntry("lastScreen", -1);
-            Dock::SessionType session = static_cast<Dock::SessionType>(containmentsEntries.group(cId).readEntry("session", (int)Dock::DefaultSession));
+    foreach (auto id, m_containmentIndex->ids()) {
+        const ContainmentInfo info = m_containmentIndex->info(id);
 
-            qDebug() << "containment values: " << onPrimary << " - " << lastScreen;
-
-            auto appletEntries = containmentsEntries.group(cId).group("Applets");
-
-            bool containsTasks = false;
-
-            foreach (auto appId, appletEntries.groupList()) {
-                if (appletEntries.group(appId).readEntry("plugin") == "org.kde.latte.plasmoid") {
-                    containsTasks = true;
-                    break;
-                }
-            }
+        if (info.plugin == "org.kde.latte.containment") {
+            qDebug() << "containment values: " << info.onPrimary << " - " << info.lastScreen;
 
-            if (containsTasks && session == Dock::DefaultSession) {
-                m_firstContainmentWithTasks = cId.toInt();
+            if (info.hasTasksPlasmoid && info.session == Dock::DefaultSession) {
+                m_firstContainmentWithTasks = id;
 
-                if (onPrimary) {
+                if (info.onPrimary) {
                     return true;
                 } else {
-                    if (lastScreen >= 0) {
-                        QString connector = m_screenPool->connector(lastScreen);
-
-                        foreach (auto scr, qGuiApp->screens()) {
-                            if (scr && scr->name() == connector) {
-                                return true;
-                                break;
-                            }
+                    if (info.lastScreen >= 0) {
+                        if (m_screenPool->screen(info.lastScreen)) {
+                            return true;
                         }
                     }
                 }
@@ -1085,24 +1486,7 @@ bool DockCorona::heuresticForLoadingDockWithTasks()
 //! latte tasks plasmoid
 bool DockCorona::containmentContainsTasks(Plasma::Containment *cont)
 {
-    auto containmentsEntries = config()->group("Containments");
-
-    foreach (auto cId, containmentsEntries.groupList()) {
-        QString plugin = containmentsEntries.group(cId).readEntry("plugin");
-
-        if ((plugin == "org.kde.latte.containment") && (cId.toUInt() == cont->id())) {
-            auto appletEntries = containmentsEntries.group(cId).group("Applets");
-
-            foreach (auto appId, appletEntries.groupList()) {
-                if (appletEntries.group(appId).readEntry("plugin") == "org.kde.latte.plasmoid") {
-                    return true;
-                    break;
-                }
-            }
-        }
-    }
-
-    return false;
+    return cont && m_containmentIndex->hasTasksPlasmoid(cont->id());
 }
 
 //! Activate launcher menu through dbus interface
@@ -1122,9 +1506,15 @@ void DockCorona::activateLauncherMenu()
     }
 }
 
-//! Activate launcher menu through dbus interface
+//! Activate task manager entry through the global shortcuts
 void DockCorona::activateTaskManagerEntry(int index, Qt::Key modifier)
 {
+    //! the Latte task managers are reached directly through their endpoints
+    if (m_taskManagerRegistry->activateTaskAtIndex(index, modifier == static_cast<Qt::Key>(Qt::CTRL), qGuiApp->primaryScreen())) {
+        return;
+    }
+
+    //! otherwise try the task managers that provide the multitasking interface
     auto activateTaskManagerEntryOnContainment = [this](const Plasma::Containment * c, int index, Qt::Key modifier) {
         const auto &applets = c->applets();
 
@@ -1193,52 +1583,41 @@ void DockCorona::activateTaskManagerEntry(int index, Qt::Key modifier)
 void DockCorona::updateDockItemBadge(QString identifier, QString value)
 {
     qDebug() << "DBUS CALL ::: " << identifier << " - " << value;
-    auto updateBadgeForTaskInContainment = [this](const Plasma::Containment * c, QString identifier, QString value) {
-        const auto &applets = c->applets();
-
-        for (auto *applet : applets) {
-            KPluginMetaData meta = applet->kPackage().metadata();
 
-            if (meta.pluginId() == "org.kde.latte.plasmoid") {
+    DockItemUpdate update;
+    update.identifier = identifier;
+    update.badge = value;
+    update.fields = DockItemUpdate::BadgeField;
 
-                if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                    const auto &childItems = appletInterface->childItems();
-
-                    if (childItems.isEmpty()) {
-                        continue;
-                    }
-
-                    for (QQuickItem *item : childItems) {
-                        if (auto *metaObject = item->metaObject()) {
-                            // not using QMetaObject::invokeMethod to avoid warnings when calling
-                            // this on applets that don't have it or other child items since this
-                            // is pretty much trial and error.
-                            // Also, "var" arguments are treated as QVariant in QMetaObject
+    // update badges in all Latte Tasks plasmoids
+    m_dockItemUpdates->enqueue(update);
+}
 
-                            int methodIndex = metaObject->indexOfMethod("updateBadge(QVariant,QVariant)");
+void DockCorona::updateDockItems(const Latte::DockItemUpdates &updates)
+{
+    m_dockItemUpdates->enqueue(updates);
+}
 
-                            if (methodIndex == -1) {
-                                continue;
-                            }
+QVariantMap DockCorona::dockItemUpdateStatistics() const
+{
+    return m_dockItemUpdates->statistics();
+}
 
-                            QMetaMethod method = metaObject->method(methodIndex);
+QVariantMap DockCorona::dockMemoryStatistics() const
+{
+    QVariantMap docks;
 
-                            if (method.invoke(item, Q_ARG(QVariant, identifier), Q_ARG(QVariant, value))) {
-                                return true;
-                            }
-                        }
-                    }
-                }
-            }
+    for (const auto view : m_dockViews) {
+        if (view->containment()) {
+            docks[QString::number(view->containment()->id())] = view->memoryTrimStatistics();
         }
+    }
 
-        return false;
-    };
+    QVariantMap statistics;
+    statistics[QStringLiteral("resident")] = residentMemory();
+    statistics[QStringLiteral("docks")] = docks;
 
-    // update badges in all Latte Tasks plasmoids
-    for (auto it = m_dockViews.constBegin(), end = m_dockViews.constEnd(); it != end; ++it) {
-        updateBadgeForTaskInContainment(it.key(), identifier, value);
-    }
+    return statistics;
 }
 
 inline void DockCorona::qmlRegisterTypes() const
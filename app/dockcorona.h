@@ -22,10 +22,14 @@
 #define DOCKCORONA_H
 
 #include "dockview.h"
+#include "dockitemupdates.h"
 #include "globalsettings.h"
 #include "../liblattedock/dock.h"
 
+#include <array>
+
 #include <QObject>
+#include <QSet>
 
 #include <KAboutApplicationDialog>
 #include <KDeclarative/QmlObject>
@@ -45,12 +49,23 @@ class Consumer;
 
 namespace Latte {
 
+class ContainmentIndex;
+class DockLoader;
+class DockSnapshots;
+class LauncherEntryListener;
+class QmlPrecompiler;
+class TaskManagerRegistry;
+
+//! the resident memory of the process in KiB, 0 when it is not available
+int residentMemory();
+
 class DockCorona : public Plasma::Corona {
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "org.kde.LatteDock")
 
 public:
-    DockCorona(QObject *parent = nullptr);
+    //! the handoff state of a replaced instance is used by the docks it had
+    DockCorona(const QVariantMap &handoffState = QVariantMap(), QObject *parent = nullptr);
     virtual ~DockCorona();
 
     int numScreens() const override;
@@ -60,11 +75,13 @@ public:
 
     QList<Plasma::Types::Location> freeEdges(int screen) const;
     QList<Plasma::Types::Location> freeEdges(QScreen *screen) const;
+    QList<Plasma::Types::Location> freeEdges(const QString &connector) const;
 
     int docksCount(int screen) const;
     int docksCount() const;
     int noDocksWithTasks() const;
     int screenForContainment(const Plasma::Containment *containment) const override;
+    Plasma::Containment *containmentById(uint id) const;
 
     void addDock(Plasma::Containment *containment);
     void recreateDock(Plasma::Containment *containment);
@@ -76,21 +93,45 @@ public:
     void aboutApplication();
     void closeApplication();
 
+    ContainmentIndex *containmentIndex() const;
     ScreenPool *screenPool() const;
     GlobalSettings *globalSettings() const;
 
+    //! the resident memory in KiB of the other session's docks, measured
+    //! when they were created or estimated from the docks created so far
+    int standbyMemoryCost() const;
+
+    //! a new instance replaces this one, the state of the shutdown is saved
+    //! now and it is not saved again when this instance exits
+    void prepareHandoff();
+    void resumeAfterHandoff();
+    //! the state that is not saved, sent to the instance that replaces this one
+    QVariantMap handoffState() const;
+
 public slots:
     void activateLauncherMenu();
     void loadDefaultLayout() override;
     void dockContainmentDestroyed(QObject *cont);
     void updateDockItemBadge(QString identifier, QString value);
+    //! the updates of a frame are merged and delivered together
+    void updateDockItems(const Latte::DockItemUpdates &updates);
+    QVariantMap dockItemUpdateStatistics() const;
+    //! the resident memory of the process and of the trims of each dock
+    QVariantMap dockMemoryStatistics() const;
 
 signals:
     void configurationShown(PlasmaQuick::ConfigView *configView);
     void currentSessionChanged(Dock::SessionType type);
     void docksCountChanged();
     void dockLocationChanged();
+    //! the free edges of that screen connector may have changed
+    void freeEdgesChanged(const QString &connector);
     void raiseDocksTemporaryChanged();
+    //! the docks of the startup have been created
+    void docksLoaded();
+    //! the first frame of the first dock was rendered
+    void firstDockVisible();
+    void standbyMemoryCostChanged();
 
 private slots:
     void destroyedChanged(bool destroyed);
@@ -101,23 +142,52 @@ private slots:
     void addOutput(QScreen *screen);
     void primaryOutputChanged();
     void screenRemoved(QScreen *screen);
-    void screenCountChanged();
     void syncDockViews();
 
 private:
     void activateTaskManagerEntry(int index, Qt::Key modifier);
     void cleanConfig();
+    //! the state that the next startup loads, saved at shutdown or handoff
+    void saveState(bool snapshots);
+    void setHandoffState(const QVariantMap &state);
+    //! the absolute path of the layout configuration file
+    QString layoutConfigFile() const;
     void qmlRegisterTypes() const;
-    bool appletExists(uint containmentId, uint appletId) const;
     bool containmentContainsTasks(Plasma::Containment *cont);
-    bool containmentExists(uint id) const;
     bool heuresticForLoadingDockWithTasks();
     int noDocksForSession(Dock::SessionType session);
     int primaryScreenId() const;
 
+    void updateDockEdge(DockView *view);
+    void removeDockEdge(const DockView *view);
+    void rebuildEdgeOccupancy();
+
+    //! the progress circle of the largest dock icons
+    void updateLauncherEntryProgressLength();
+
+    //! the docks of the other session are kept hidden when the
+    //! sessions are kept loaded, switching just shows them again
+    void parkDock(Plasma::Containment *containment, DockView *view);
+    void measureDockMemory(DockView *view);
+    void finishDockMemory(DockView *view);
+    bool restoreStandbyDock(Plasma::Containment *containment, const QString &connector, bool updateScreenId);
+    void warmStandbyDocks();
+    void releaseStandbyDocks();
+
+    //! compiles in idle time the qml of the packages that is not precompiled
+    void precompileQml();
+
     bool m_activitiesStarting{true};
+    //! the state was saved for the instance that replaces this one
+    bool m_handedOff{false};
+    //! the visibility of the docks of the replaced instance, by containment id
+    QVariantMap m_handoffDocks;
+    //! the startup trace time when the activities service was waited for
+    qint64 m_activitiesWaitBegin{0};
     //! used to initialize the docks when changing sessions
     bool m_waitingSessionDocksCreation{false};
+    //! addDock creates the docks of the other session hidden
+    bool m_warmingStandbyDocks{false};
     //! this is used to check if a dock with tasks in it will be loaded on startup
     bool m_tasksWillBeLoaded{false};
     //! this is used to record the first dock having tasks in it. It is used
@@ -129,15 +199,35 @@ private:
 
     QHash<const Plasma::Containment *, DockView *> m_dockViews;
     QHash<const Plasma::Containment *, DockView *> m_waitingDockViews;
+    QHash<const Plasma::Containment *, DockView *> m_standbyDockViews;
+    //! the containments whose dock view is being created right now
+    QSet<const Plasma::Containment *> m_creatingDocks;
+    //! containment id -> resident memory in KiB that its dock took
+    QHash<uint, int> m_dockMemoryCost;
+    //! the docks whose cost is being measured -> resident memory before
+    //! their creation, -1 when another dock was created meanwhile
+    QHash<const DockView *, int> m_memoryMeasures;
+
+    //! the docks at Top, Bottom, Left and Right edges
+    using EdgeSlots = std::array<int, 4>;
+    //! screen connector -> docks for each edge
+    QHash<QString, EdgeSlots> m_edgeOccupancy;
+    //! the slot each dock has taken, connector and location
+    QHash<const DockView *, QPair<QString, Plasma::Types::Location>> m_dockEdges;
     QList<KDeclarative::QmlObject *> m_alternativesObjects;
 
-    QTimer m_docksScreenSyncTimer;
-
     KActivities::Consumer *m_activityConsumer;
     QPointer<KAboutApplicationDialog> aboutDialog;
 
     ScreenPool *m_screenPool;
+    ContainmentIndex *m_containmentIndex;
+    DockLoader *m_dockLoader;
+    DockSnapshots *m_dockSnapshots;
+    TaskManagerRegistry *m_taskManagerRegistry;
+    DockItemUpdateQueue *m_dockItemUpdates;
     GlobalSettings *m_globalSettings;
+    LauncherEntryListener *m_launcherEntries{nullptr};
+    QmlPrecompiler *m_qmlPrecompiler{nullptr};
 };
 
 }
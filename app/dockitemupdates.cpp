@@ -0,0 +1,169 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dockitemupdates.h"
+#include "taskmanagerregistry.h"
+
+
+namespace Latte {
+
+void DockItemUpdate::merge(const DockItemUpdate &newer)
+{
+    if (newer.fields & BadgeField) {
+        badge = newer.badge;
+    }
+
+    if (newer.fields & ProgressField) {
+        progress = newer.progress;
+    }
+
+    if (newer.fields & UrgentField) {
+        urgent = newer.urgent;
+    }
+
+    fields |= newer.fields;
+}
+
+QVariantMap DockItemUpdate::toVariantMap() const
+{
+    QVariantMap map;
+    map[QStringLiteral("identifier")] = identifier;
+
+    if (fields & BadgeField) {
+        map[QStringLiteral("badge")] = badge;
+    }
+
+    if (fields & ProgressField) {
+        map[QStringLiteral("progress")] = progress;
+    }
+
+    if (fields & UrgentField) {
+        map[QStringLiteral("urgent")] = urgent;
+    }
+
+    return map;
+}
+
+DockItemUpdateQueue::DockItemUpdateQueue(TaskManagerRegistry *registry, QObject *parent)
+    : QObject(parent),
+      m_registry(registry)
+{
+    //! one frame, everything received meanwhile is delivered together
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setInterval(16);
+    connect(&m_frameTimer, &QTimer::timeout, this, &DockItemUpdateQueue::flush);
+}
+
+DockItemUpdateQueue::~DockItemUpdateQueue()
+{
+}
+
+void DockItemUpdateQueue::enqueue(const DockItemUpdate &update)
+{
+    ++m_received;
+
+    if (update.identifier.isEmpty() || update.fields == DockItemUpdate::NoField) {
+        ++m_dropped;
+        return;
+    }
+
+    auto it = m_pending.find(update.identifier);
+
+    if (it != m_pending.end()) {
+        it->merge(update);
+        ++m_merged;
+    } else {
+        m_pending.insert(update.identifier, update);
+        m_order << update.identifier;
+    }
+
+    if (!m_frameTimer.isActive()) {
+        m_frameTimer.start();
+    }
+}
+
+void DockItemUpdateQueue::enqueue(const DockItemUpdates &updates)
+{
+    foreach (const DockItemUpdate &update, updates) {
+        enqueue(update);
+    }
+}
+
+void DockItemUpdateQueue::flush()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QVariantList batch;
+    batch.reserve(m_order.size());
+
+    foreach (const QString &identifier, m_order) {
+        batch << m_pending.value(identifier).toVariantMap();
+    }
+
+    m_pending.clear();
+    m_order.clear();
+
+    if (m_registry->count() == 0) {
+        m_dropped += batch.size();
+        return;
+    }
+
+    m_registry->updateItems(batch);
+    m_delivered += batch.size();
+    ++m_batches;
+}
+
+QVariantMap DockItemUpdateQueue::statistics() const
+{
+    QVariantMap stats;
+    stats[QStringLiteral("received")] = m_received;
+    stats[QStringLiteral("merged")] = m_merged;
+    stats[QStringLiteral("dropped")] = m_dropped;
+    stats[QStringLiteral("delivered")] = m_delivered;
+    stats[QStringLiteral("batches")] = m_batches;
+
+    return stats;
+}
+
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const Latte::DockItemUpdate &update)
+{
+    argument.beginStructure();
+    argument << update.identifier << update.badge << update.progress << update.urgent;
+    argument.endStructure();
+
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, Latte::DockItemUpdate &update)
+{
+    argument.beginStructure();
+    argument >> update.identifier >> update.badge >> update.progress >> update.urgent;
+    argument.endStructure();
+
+    //! the D-Bus tuples always carry the whole state of the item
+    update.fields = Latte::DockItemUpdate::BadgeField | Latte::DockItemUpdate::ProgressField
+                    | Latte::DockItemUpdate::UrgentField;
+
+    return argument;
+}
@@ -0,0 +1,106 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DOCKITEMUPDATES_H
+#define DOCKITEMUPDATES_H
+
+#include <QDBusArgument>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVariantMap>
+
+namespace Latte {
+
+class TaskManagerRegistry;
+
+//! the state of a dock item as it is sent by external applications,
+//! identifier is the desktop file name without the .desktop suffix
+struct DockItemUpdate {
+    enum Field {
+        NoField = 0,
+        BadgeField = 1,
+        ProgressField = 2,
+        UrgentField = 4
+    };
+
+    QString identifier;
+    QString badge;
+    //! 0-100, -1 hides the progress
+    int progress{ -1};
+    bool urgent{false};
+    //! the fields that this update sets, the rest are left untouched
+    int fields{BadgeField | ProgressField | UrgentField};
+
+    //! the fields of the newer update replace the ones of this
+    void merge(const DockItemUpdate &newer);
+    QVariantMap toVariantMap() const;
+};
+
+using DockItemUpdates = QList<DockItemUpdate>;
+
+/**
+ * @brief The DockItemUpdateQueue class, coalesces the dock item updates that
+ * are received during one frame and delivers them as one batch to each
+ * Latte task manager. Superseded values of the same item are merged.
+ */
+class DockItemUpdateQueue : public QObject {
+    Q_OBJECT
+
+public:
+    DockItemUpdateQueue(TaskManagerRegistry *registry, QObject *parent = nullptr);
+    ~DockItemUpdateQueue() override;
+
+    void enqueue(const DockItemUpdate &update);
+    void enqueue(const DockItemUpdates &updates);
+
+    //! received, merged, dropped and delivered updates and the batches sent
+    QVariantMap statistics() const;
+
+private:
+    void flush();
+
+    TaskManagerRegistry *m_registry{nullptr};
+
+    //! identifier -> pending update, the order of first arrival is kept
+    QHash<QString, DockItemUpdate> m_pending;
+    QStringList m_order;
+
+    QTimer m_frameTimer;
+
+    quint64 m_received{0};
+    quint64 m_merged{0};
+    quint64 m_dropped{0};
+    quint64 m_delivered{0};
+    quint64 m_batches{0};
+};
+
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const Latte::DockItemUpdate &update);
+const QDBusArgument &operator>>(const QDBusArgument &argument, Latte::DockItemUpdate &update);
+
+Q_DECLARE_METATYPE(Latte::DockItemUpdate)
+Q_DECLARE_METATYPE(Latte::DockItemUpdates)
+
+#endif // DOCKITEMUPDATES_H
@@ -0,0 +1,234 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dockloader.h"
+#include "containmentindex.h"
+#include "dockcorona.h"
+#include "dockview.h"
+#include "../liblattedock/startuptrace.h"
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QQmlEngine>
+
+#include <Plasma/Containment>
+
+namespace Latte {
+
+//! the time that is given to the incubation in every slice, the rest
+//! of the frame is left for rendering and input
+constexpr int IncubationSlice = 5;
+constexpr int IncubationInterval = 16;
+//! a dock that does not render, e.g. hidden, does not block the rest
+constexpr int NextDockTimeout = 100;
+
+IdleIncubationController::IdleIncubationController(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(IncubationInterval);
+    connect(&m_timer, &QTimer::timeout, this, [this]() {
+        LATTE_TRACE_SCOPE("QML incubation");
+        incubateFor(IncubationSlice);
+    });
+}
+
+IdleIncubationController::~IdleIncubationController()
+{
+}
+
+void IdleIncubationController::incubatingObjectCountChanged(int count)
+{
+    if (count > 0 && !m_timer.isActive()) {
+        m_timer.start();
+    } else if (count == 0) {
+        m_timer.stop();
+        emit idle();
+    }
+}
+
+DockLoader::DockLoader(DockCorona *corona)
+    : QObject(corona),
+      m_incubationController(new IdleIncubationController(this)),
+      m_corona(corona)
+{
+    m_startupTimer.start();
+
+    m_nextTimer.setSingleShot(true);
+    connect(&m_nextTimer, &QTimer::timeout, this, &DockLoader::loadNext);
+}
+
+DockLoader::~DockLoader()
+{
+    if (m_engine && m_engine->incubationController() == m_incubationController) {
+        m_engine->setIncubationController(nullptr);
+    }
+}
+
+void DockLoader::hold()
+{
+    m_holding = true;
+}
+
+bool DockLoader::isHolding() const
+{
+    return m_holding;
+}
+
+void DockLoader::enqueue(Plasma::Containment *containment)
+{
+    if (containment && !m_queue.contains(containment)) {
+        m_queue.append(containment);
+    }
+}
+
+void DockLoader::start()
+{
+    m_holding = false;
+    m_loading = true;
+
+    std::stable_sort(m_queue.begin(), m_queue.end(), [this](const QPointer<Plasma::Containment> &a
+    , const QPointer<Plasma::Containment> &b) {
+        return priority(a) < priority(b);
+    });
+
+    qDebug() << "dock loader: docks queued:" << m_queue.count();
+
+    //! the first dock is created right away, the rest in idle time
+    loadNext();
+}
+
+int DockLoader::priority(Plasma::Containment *containment) const
+{
+    if (!containment) {
+        return 4;
+    }
+
+    const ContainmentInfo info = m_corona->containmentIndex()->info(containment->id());
+    int priority = info.onPrimary ? 0 : 1;
+
+    if (!info.hasTasksPlasmoid) {
+        priority += 2;
+    }
+
+    return priority;
+}
+
+void DockLoader::prepare(DockView *view)
+{
+    QQmlEngine *engine = view ? view->engine() : nullptr;
+
+    if (m_loading && engine && !engine->incubationController()) {
+        engine->setIncubationController(m_incubationController);
+        m_engine = engine;
+    }
+}
+
+void DockLoader::releaseIncubationController()
+{
+    if (!m_engine || m_engine->incubationController() != m_incubationController) {
+        return;
+    }
+
+    //! the objects still incubating would never complete without it,
+    //! the engine is not changed from inside its own incubation
+    if (m_incubationController->incubatingObjectCount() > 0) {
+        connect(m_incubationController, &IdleIncubationController::idle
+                , this, &DockLoader::releaseIncubationController
+                , static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::UniqueConnection));
+        return;
+    }
+
+    disconnect(m_incubationController, &IdleIncubationController::idle
+               , this, &DockLoader::releaseIncubationController);
+    m_engine->setIncubationController(nullptr);
+    qDebug() << "dock loader: incubation controller released";
+}
+
+void DockLoader::dockShown(DockView *view)
+{
+    //! the frame that counts is the first one with the dock ui
+    if (!view->isUiReady()) {
+        connect(view, &DockView::uiReady, this, [this, view]() {
+            disconnect(view, &DockView::uiReady, this, nullptr);
+            dockShown(view);
+        });
+        return;
+    }
+
+    connect(view, &QQuickWindow::frameSwapped, this, [this, view]() {
+        disconnect(view, &QQuickWindow::frameSwapped, this, nullptr);
+
+        if (m_firstDockVisible < 0) {
+            m_firstDockVisible = m_startupTimer.elapsed();
+            qDebug() << "dock loader: first dock visible after" << m_firstDockVisible << "ms";
+            StartupTrace::instant("first dock visible");
+            emit firstDockVisible(m_firstDockVisible);
+        }
+
+        emit dockVisible(view);
+
+        if (!m_queue.isEmpty()) {
+            m_nextTimer.start(0);
+        }
+    });
+}
+
+qint64 DockLoader::firstDockVisibleTime() const
+{
+    return m_firstDockVisible;
+}
+
+void DockLoader::loadNext()
+{
+    //! the incubation processes events, a dock must not be created
+    //! while the previous one is still being created
+    if (m_creating || m_holding) {
+        return;
+    }
+
+    while (!m_queue.isEmpty()) {
+        QPointer<Plasma::Containment> containment = m_queue.takeFirst();
+
+        if (!containment) {
+            continue;
+        }
+
+        const int docks = m_corona->docksCount();
+
+        m_creating = true;
+        m_corona->addDock(containment);
+        m_creating = false;
+
+        //! a rejected dock, e.g. its screen is not available, does not wait
+        if (m_corona->docksCount() > docks) {
+            m_nextTimer.start(NextDockTimeout);
+            return;
+        }
+    }
+
+    m_nextTimer.stop();
+    m_loading = false;
+    qDebug() << "dock loader: all docks loaded after" << m_startupTimer.elapsed() << "ms";
+    releaseIncubationController();
+    emit finished();
+}
+
+}
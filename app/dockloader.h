@@ -0,0 +1,124 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DOCKLOADER_H
+#define DOCKLOADER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQmlIncubationController>
+#include <QTimer>
+
+class QQmlEngine;
+
+namespace Plasma {
+class Containment;
+}
+
+namespace Latte {
+
+class DockCorona;
+class DockView;
+
+/**
+ * @brief The IdleIncubationController class, incubates the asynchronous QML
+ * objects of the shared engine in small slices so the docks that are already
+ * shown keep rendering while the rest of the QML is created.
+ */
+class IdleIncubationController : public QObject, public QQmlIncubationController {
+    Q_OBJECT
+
+public:
+    IdleIncubationController(QObject *parent = nullptr);
+    ~IdleIncubationController() override;
+
+signals:
+    //! nothing is being incubated anymore
+    void idle();
+
+protected:
+    void incubatingObjectCountChanged(int count) override;
+
+private:
+    QTimer m_timer;
+};
+
+/**
+ * @brief The DockLoader class, creates the docks of the startup one by one.
+ *
+ * The containments that are added while the layout is loaded are queued.
+ * The dock holding the tasks plasmoid on the primary screen is created first
+ * and the rest follow one per frame, their ui is incubated asynchronously.
+ */
+class DockLoader : public QObject {
+    Q_OBJECT
+
+public:
+    DockLoader(DockCorona *corona);
+    ~DockLoader() override;
+
+    //! the containments added after hold() are queued until start()
+    void hold();
+    void start();
+    bool isHolding() const;
+
+    void enqueue(Plasma::Containment *containment);
+
+    //! installs the incubation controller on the engine of the view while
+    //! the docks are loaded, the docks added later are created synchronously
+    void prepare(DockView *view);
+    //! a dock view was shown, the next one is created after its first frame
+    void dockShown(DockView *view);
+
+    //! milliseconds from the start of the application to the first frame
+    //! of the first dock, -1 until then
+    qint64 firstDockVisibleTime() const;
+
+signals:
+    void firstDockVisible(qint64 msecs);
+    //! the first frame of that dock view has been rendered
+    void dockVisible(DockView *view);
+    void finished();
+
+private:
+    void loadNext();
+    void releaseIncubationController();
+    int priority(Plasma::Containment *containment) const;
+
+    bool m_holding{false};
+    bool m_loading{false};
+    bool m_creating{false};
+    qint64 m_firstDockVisible{ -1};
+
+    QList<QPointer<Plasma::Containment>> m_queue;
+
+    QElapsedTimer m_startupTimer;
+    QTimer m_nextTimer;
+
+    IdleIncubationController *m_incubationController{nullptr};
+    QPointer<QQmlEngine> m_engine;
+    DockCorona *m_corona{nullptr};
+};
+
+}
+
+#endif // DOCKLOADER_H
@@ -0,0 +1,184 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dockplacement.h"
+
+#include <algorithm>
+
+namespace Latte {
+namespace DockPlacement {
+
+namespace {
+//! the edges that are taken on each screen while the plan is built
+class Occupancy {
+public:
+    bool isFree(const QString &screen, Plasma::Types::Location location) const {
+        return !m_edges.value(screen).contains(location);
+    }
+
+    void take(const QString &screen, Plasma::Types::Location location) {
+        m_edges[screen].insert(location);
+    }
+
+private:
+    QHash<QString, QSet<Plasma::Types::Location>> m_edges;
+};
+}
+
+QList<Action> plan(const Topology &topology, const QList<DockState> &docks, Dock::SessionType session)
+{
+    QList<Action> deletions;
+    QList<Action> moves;
+    QList<Action> creations;
+
+    QList<DockState> sorted = docks;
+    std::sort(sorted.begin(), sorted.end(), [](const DockState & a, const DockState & b) {
+        return a.id < b.id;
+    });
+
+    auto isPresent = [&topology](const QString & screen) {
+        return !screen.isEmpty() && topology.screens.contains(screen);
+    };
+
+    auto moveOrStay = [&moves](const DockState & dock, const QString & screen, bool updateScreenId) {
+        if (dock.screen != screen) {
+            moves << Action{MoveDock, dock.id, screen, updateScreenId};
+        }
+    };
+
+    Occupancy occupancy;
+    QList<DockState> running;
+    int runningTasks{0};
+    bool tasksWillBeShown{false};
+
+    foreach (const DockState &dock, sorted) {
+        if (!dock.running) {
+            continue;
+        }
+
+        if (dock.session != session) {
+            deletions << Action{DeleteDock, dock.id, QString(), true};
+            continue;
+        }
+
+        running << dock;
+
+        if (dock.hasTasks) {
+            ++runningTasks;
+
+            if (dock.onPrimary || isPresent(dock.explicitScreen)) {
+                tasksWillBeShown = true;
+            }
+        }
+    }
+
+    //! this tries to find a dock that must not be deleted by the automatic
+    //! algorithm. Currently the dock with the minimum id containing tasks
+    //! plasmoid wins, when no other tasks dock will be shown
+    uint preserveId{0};
+    bool preserve{false};
+
+    if (!tasksWillBeShown) {
+        foreach (const DockState &dock, running) {
+            if (dock.hasTasks && !dock.onPrimary && !isPresent(dock.explicitScreen)) {
+                preserveId = dock.id;
+                preserve = true;
+                break;
+            }
+        }
+    }
+
+    QList<DockState> primaryDocks;
+    //! explicit docks whose screen is missing but must stay visible
+    QList<DockState> homelessDocks;
+
+    //! 1. explicit docks keep their screen, when their screen is missing they
+    //! are deleted unless they are the last or the preserved tasks dock
+    foreach (const DockState &dock, running) {
+        if (dock.onPrimary) {
+            primaryDocks << dock;
+        } else if (isPresent(dock.explicitScreen)) {
+            occupancy.take(dock.explicitScreen, dock.location);
+            moveOrStay(dock, dock.explicitScreen, true);
+        } else if (running.size() == 1 || (dock.hasTasks && runningTasks == 1)
+                   || (preserve && dock.id == preserveId)) {
+            homelessDocks << dock;
+        } else {
+            deletions << Action{DeleteDock, dock.id, QString(), true};
+        }
+    }
+
+    //! 2. primary docks that are already at the primary screen keep their edge
+    foreach (const DockState &dock, primaryDocks) {
+        if (dock.screen == topology.primary) {
+            occupancy.take(topology.primary, dock.location);
+        }
+    }
+
+    //! 3. the rest of the primary docks move to the primary screen when their
+    //! edge is free there, otherwise they stay if their screen still exists
+    foreach (const DockState &dock, primaryDocks) {
+        if (dock.screen == topology.primary) {
+            continue;
+        }
+
+        if (occupancy.isFree(topology.primary, dock.location)) {
+            occupancy.take(topology.primary, dock.location);
+            moveOrStay(dock, topology.primary, true);
+        } else if (isPresent(dock.screen)) {
+            occupancy.take(dock.screen, dock.location);
+        } else {
+            deletions << Action{DeleteDock, dock.id, QString(), true};
+        }
+    }
+
+    //! 4. the docks without screen are shown temporarily at the primary screen,
+    //! they return to their screen when it is reconnected
+    foreach (const DockState &dock, homelessDocks) {
+        if (occupancy.isFree(topology.primary, dock.location)) {
+            occupancy.take(topology.primary, dock.location);
+            moveOrStay(dock, topology.primary, false);
+        } else if (isPresent(dock.screen)) {
+            occupancy.take(dock.screen, dock.location);
+        }
+    }
+
+    //! 5. two main situations that a dock must be added when it is not already running
+    //! a. when a dock is primary, not running and the edge for which is associated is free
+    //! b. when a dock in explicit, not running and the associated screen currently exists
+    foreach (const DockState &dock, sorted) {
+        if (dock.running || dock.session != session) {
+            continue;
+        }
+
+        if (dock.onPrimary && occupancy.isFree(topology.primary, dock.location)) {
+            occupancy.take(topology.primary, dock.location);
+            creations << Action{CreateDock, dock.id, topology.primary, true};
+        } else if (!dock.onPrimary && isPresent(dock.explicitScreen)) {
+            occupancy.take(dock.explicitScreen, dock.location);
+            creations << Action{CreateDock, dock.id, dock.explicitScreen, true};
+        }
+    }
+
+    return deletions + moves + creations;
+}
+
+}
+}
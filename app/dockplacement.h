@@ -0,0 +1,91 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DOCKPLACEMENT_H
+#define DOCKPLACEMENT_H
+
+#include "../liblattedock/dock.h"
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include <Plasma>
+
+namespace Latte {
+
+/**
+ * @brief The DockPlacement namespace, computes which docks must be created,
+ * deleted or moved for a screen topology.
+ *
+ * It works only on plain values, so DockCorona collects the dock model once,
+ * gets the whole plan in one pass and applies it at once instead of each
+ * dock reconsidering its screen on its own.
+ */
+namespace DockPlacement {
+
+struct Topology {
+    //! the connectors of the running screens
+    QSet<QString> screens;
+    QString primary;
+};
+
+struct DockState {
+    uint id{0};
+    //! true when a dock view exists for the containment
+    bool running{false};
+    //! the connector the running view is shown at
+    QString screen;
+    //! the connector of the explicit screen, empty if it is unknown
+    QString explicitScreen;
+    bool onPrimary{true};
+    bool hasTasks{false};
+    Plasma::Types::Location location{Plasma::Types::BottomEdge};
+    Dock::SessionType session{Dock::DefaultSession};
+};
+
+enum ActionType {
+    CreateDock = 0,
+    DeleteDock,
+    MoveDock
+};
+
+struct Action {
+    ActionType type{CreateDock};
+    uint id{0};
+    //! the target connector for CreateDock and MoveDock
+    QString screen;
+    //! false when a dock is shown temporarily on the primary screen and
+    //! must return to its explicit screen when that is reconnected
+    bool updateScreenId{true};
+};
+
+/*!
+ * @brief the minimal set of actions that brings the docks of that session
+ * to the topology. The deletions come first, then the moves and the creations
+ */
+QList<Action> plan(const Topology &topology, const QList<DockState> &docks, Dock::SessionType session);
+
+}
+
+}
+
+#endif // DOCKPLACEMENT_H
@@ -0,0 +1,229 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "docksnapshots.h"
+#include "dockview.h"
+#include "../liblattedock/startuptrace.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QPainter>
+#include <QRasterWindow>
+#include <QScreen>
+#include <QStandardPaths>
+
+#include <KWindowSystem>
+
+#include <Plasma/Containment>
+
+namespace Latte {
+
+//! the snapshots of docks that are not created, e.g. their screen changed,
+//! are removed after that time
+constexpr int SnapshotTimeout = 20000;
+
+namespace {
+
+QString rectToString(const QRect &rect)
+{
+    return QStringLiteral("%1,%2,%3,%4").arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height());
+}
+
+QRect rectFromString(const QString &text)
+{
+    const QStringList values = text.split(QLatin1Char(','));
+
+    if (values.count() != 4) {
+        return QRect();
+    }
+
+    return QRect(values.at(0).toInt(), values.at(1).toInt(), values.at(2).toInt(), values.at(3).toInt());
+}
+
+//! a plain raster window, it does not need the scene graph or any QML
+class SnapshotWindow final : public QRasterWindow {
+public:
+    SnapshotWindow(const QImage &image, const QRect &geometry, const QRect &mask)
+        : m_image(image)
+    {
+        QSurfaceFormat format;
+        format.setAlphaBufferSize(8);
+        setFormat(format);
+
+        setFlags(Qt::FramelessWindowHint
+                 | Qt::WindowStaysOnTopHint
+                 | Qt::NoDropShadowWindowHint
+                 | Qt::WindowDoesNotAcceptFocus
+                 | Qt::BypassWindowManagerHint);
+        setGeometry(geometry);
+
+        //! the transparent area is cut out when there is no compositing
+        if (!mask.isNull() && !KWindowSystem::compositingActive()) {
+            setMask(mask);
+        }
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override {
+        QPainter painter(this);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(0, 0, m_image);
+    }
+
+private:
+    QImage m_image;
+};
+
+}
+
+DockSnapshots::DockSnapshots(QObject *parent)
+    : QObject(parent)
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(SnapshotTimeout);
+    connect(&m_timeout, &QTimer::timeout, this, &DockSnapshots::hideAll);
+}
+
+DockSnapshots::~DockSnapshots()
+{
+    qDeleteAll(m_windows);
+}
+
+QString DockSnapshots::directory() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/snapshots");
+}
+
+void DockSnapshots::show()
+{
+    LATTE_TRACE_SCOPE("DockSnapshots::show");
+
+    //! the windows can not be positioned there
+    if (KWindowSystem::isPlatformWayland()) {
+        return;
+    }
+
+    QDir dir(directory());
+    const auto files = dir.entryInfoList({QStringLiteral("*.png")}, QDir::Files);
+
+    for (const auto &file : files) {
+        QImageReader reader(file.absoluteFilePath());
+        const QRect geometry = rectFromString(reader.text(QStringLiteral("geometry")));
+        const QRect mask = rectFromString(reader.text(QStringLiteral("mask")));
+        const QString connector = reader.text(QStringLiteral("screen"));
+        const QRect screenGeometry = rectFromString(reader.text(QStringLiteral("screenGeometry")));
+        const QImage image = reader.read();
+
+        //! the snapshots are used once
+        dir.remove(file.fileName());
+
+        if (image.isNull() || geometry.isNull() || image.size() != geometry.size()) {
+            continue;
+        }
+
+        bool screenIsSame{false};
+
+        for (const auto scr : qGuiApp->screens()) {
+            if (scr->name() == connector && scr->geometry() == screenGeometry) {
+                screenIsSame = true;
+                break;
+            }
+        }
+
+        if (!screenIsSame) {
+            continue;
+        }
+
+        auto window = new SnapshotWindow(image, geometry, mask);
+        window->show();
+        m_windows[file.baseName().toUInt()] = window;
+    }
+
+    qDebug() << "dock snapshots shown:" << m_windows.count();
+
+    if (!m_windows.isEmpty()) {
+        m_timeout.start();
+    }
+}
+
+void DockSnapshots::save(const QList<DockView *> &views)
+{
+    QDir dir(directory());
+
+    if (!dir.mkpath(QStringLiteral("."))) {
+        return;
+    }
+
+    for (const auto &file : dir.entryList({QStringLiteral("*.png")}, QDir::Files)) {
+        dir.remove(file);
+    }
+
+    if (KWindowSystem::isPlatformWayland()) {
+        return;
+    }
+
+    for (const auto view : views) {
+        if (!view || !view->isVisible() || !view->containment() || !view->screen()) {
+            continue;
+        }
+
+        QImage image = view->grabWindow();
+
+        if (image.isNull()) {
+            continue;
+        }
+
+        image.setText(QStringLiteral("geometry"), rectToString(view->geometry()));
+        image.setText(QStringLiteral("mask"), rectToString(view->maskArea()));
+        image.setText(QStringLiteral("screen"), view->screen()->name());
+        image.setText(QStringLiteral("screenGeometry"), rectToString(view->screen()->geometry()));
+
+        image.save(dir.filePath(QStringLiteral("%1.png").arg(view->containment()->id())), "PNG");
+    }
+}
+
+void DockSnapshots::dockReady(uint containmentId)
+{
+    QRasterWindow *window = m_windows.take(containmentId);
+
+    if (window) {
+        window->hide();
+        window->deleteLater();
+    }
+
+    if (m_windows.isEmpty()) {
+        m_timeout.stop();
+    }
+}
+
+void DockSnapshots::hideAll()
+{
+    for (auto window : m_windows) {
+        window->hide();
+        window->deleteLater();
+    }
+
+    m_windows.clear();
+    m_timeout.stop();
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DOCKSNAPSHOTS_H
+#define DOCKSNAPSHOTS_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+class QRasterWindow;
+
+namespace Latte {
+
+class DockView;
+
+/**
+ * @brief The DockSnapshots class, the images of the docks that are saved at
+ * a clean shutdown and shown at the next startup until the real docks
+ * render their first frame.
+ *
+ * Each snapshot is a png in the cache directory that carries the window
+ * geometry, the mask and the screen of the dock as text entries. It is
+ * shown only when that screen has the same geometry as when it was saved.
+ */
+class DockSnapshots : public QObject {
+    Q_OBJECT
+
+public:
+    DockSnapshots(QObject *parent = nullptr);
+    ~DockSnapshots() override;
+
+    //! shows the snapshots of the last shutdown, they are used once
+    void show();
+    //! replaces the previous snapshots with the ones of these docks
+    void save(const QList<DockView *> &views);
+
+    //! the dock of that containment rendered its first frame
+    void dockReady(uint containmentId);
+    void hideAll();
+
+private:
+    QString directory() const;
+
+    //! containment id -> snapshot window
+    QHash<uint, QRasterWindow *> m_windows;
+
+    QTimer m_timeout;
+};
+
+}
+
+#endif // DOCKSNAPSHOTS_H
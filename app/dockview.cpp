@@ -23,12 +23,16 @@
 #include "dockcorona.h"
 #include "globalsettings.h"
 #include "panelshadows_p.h"
+#include "screenpool.h"
 #include "visibilitymanager.h"
 #include "../liblattedock/extras.h"
+#include "../liblattedock/startuptrace.h"
 
 #include <QAction>
+#include <QQmlComponent>
 #include <QQmlContext>
 #include <QQmlEngine>
+#include <QQmlIncubator>
 #include <QQmlProperty>
 #include <QQuickItem>
 #include <QMenu>
@@ -45,8 +49,34 @@
 #include <Plasma/ContainmentActions>
 #include <PlasmaQuick/AppletQuickItem>
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 namespace Latte {
 
+//! the incubation of the dock ui is sliced by the incubation controller
+//! of the engine, without one it is completed synchronously
+class UiIncubator : public QQmlIncubator {
+public:
+    UiIncubator(DockView *view)
+        : QQmlIncubator(QQmlIncubator::Asynchronous),
+          m_view(view)
+    {
+    }
+
+protected:
+    void statusChanged(Status status) override
+    {
+        if (status == QQmlIncubator::Ready || status == QQmlIncubator::Error) {
+            m_view->uiIncubated();
+        }
+    }
+
+private:
+    DockView *m_view;
+};
+
 //! both alwaysVisible and dockWinBehavior are passed through corona because
 //! during the dock window creation containment hasnt been set, but these variables
 //! are needed in order for window flags to be set correctly
@@ -90,6 +120,7 @@ DockView::DockView(Plasma::Corona *corona, QScreen *targetScreen, bool dockWindo
 
         if (!m_visibility) {
             m_visibility = new VisibilityManager(this);
+            connect(m_visibility.data(), &VisibilityManager::isHiddenChanged, this, &DockView::updateIdleTrim);
         }
 
         QAction *lockWidgetsAction = this->containment()->actions()->action("lock widgets");
@@ -110,6 +141,11 @@ DockView::DockView(Plasma::Corona *corona, QScreen *targetScreen, bool dockWindo
     if (dockCorona) {
         connect(dockCorona, &DockCorona::docksCountChanged, this, &DockView::docksCountChanged);
         connect(dockCorona, &DockCorona::dockLocationChanged, this, &DockView::dockLocationChanged);
+        connect(dockCorona, &DockCorona::freeEdgesChanged, this, [&](const QString & connector) {
+            if (connector == currentScreen() || (screen() && connector == screen()->name())) {
+                emit freeEdgesChanged();
+            }
+        });
         connect(dockCorona, &DockCorona::dockLocationChanged, this, [&]() {
             //! check if an edge has been freed for a primary dock
             //! from another screen
@@ -119,6 +155,9 @@ DockView::DockView(Plasma::Corona *corona, QScreen *targetScreen, bool dockWindo
         });
     }
 
+    m_idleTrimTimer.setSingleShot(true);
+    connect(&m_idleTrimTimer, &QTimer::timeout, this, &DockView::releaseIdleResources);
+
     m_screenSyncTimer.setSingleShot(true);
     m_screenSyncTimer.setInterval(2000);
     connect(&m_screenSyncTimer, &QTimer::timeout, this, &DockView::reconsiderScreen);
@@ -129,6 +168,11 @@ DockView::~DockView()
     m_screenSyncTimer.stop();
 
     qDebug() << "dock view deleting...";
+
+    //! the incubation is aborted, the ui does not outlive its context
+    delete m_uiIncubator;
+    delete m_uiRoot;
+
     rootContext()->setContextProperty(QStringLiteral("dock"), nullptr);
 
     //! this disconnect does not free up connections correctly when
@@ -147,9 +191,9 @@ DockView::~DockView()
 
 void DockView::init()
 {
+    LATTE_TRACE_SCOPE("DockView::init");
+
     connect(this, &QQuickWindow::screenChanged, this, &DockView::screenChanged);
-    connect(qGuiApp, &QGuiApplication::screenAdded, this, &DockView::screenChanged);
-    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &DockView::screenChanged);
     connect(this, &DockView::screenGeometryChanged, this, &DockView::syncGeometry);
     connect(this, &QQuickWindow::xChanged, this, &DockView::xChanged);
     connect(this, &QQuickWindow::xChanged, this, &DockView::updateAbsDockGeometry);
@@ -187,24 +231,99 @@ void DockView::init()
 
     if (dockCorona) {
         rootContext()->setContextProperty(QStringLiteral("globalSettings"), dockCorona->globalSettings());
+        connect(dockCorona->globalSettings(), &GlobalSettings::idleTrimDelayChanged, this, &DockView::updateIdleTrim);
     }
 
-    setSource(corona()->kPackage().filePath("lattedockui"));
-    setVisible(true);
-    syncGeometry();
-    qDebug() << "SOURCE:" << source();
+    //! the window root is tiny and ContainmentView needs it for the
+    //! containment, the dock ui is incubated and placed in it afterwards,
+    //! so while the docks are loaded it does not block the docks already shown
+    StartupTrace::Span qmlSpan("QML load", "qml");
+    setSource(corona()->kPackage().filePath("lattedockroot"));
+
+    const QUrl source = QUrl::fromLocalFile(corona()->kPackage().filePath("lattedockui"));
+    m_uiComponent = new QQmlComponent(engine(), source, QQmlComponent::Asynchronous, this);
+
+    if (m_uiComponent->isLoading()) {
+        connect(m_uiComponent, &QQmlComponent::statusChanged, this, &DockView::createUi);
+    } else {
+        createUi();
+    }
+
+    qmlSpan.finish();
+    qDebug() << "SOURCE:" << source;
+}
+
+void DockView::createUi()
+{
+    if (m_uiComponent->isLoading() || m_uiIncubator) {
+        return;
+    }
+
+    if (m_uiComponent->isError()) {
+        qWarning() << "dock ui can not be loaded:" << m_uiComponent->errors();
+        return;
+    }
+
+    m_uiIncubator = new UiIncubator(this);
+    m_uiComponent->create(*m_uiIncubator, rootContext());
+}
+
+void DockView::uiIncubated()
+{
+    if (m_uiIncubator->isError()) {
+        qWarning() << "dock ui can not be created:" << m_uiIncubator->errors();
+        return;
+    }
+
+    m_uiRoot = qobject_cast<QQuickItem *>(m_uiIncubator->object());
+
+    if (!m_uiRoot) {
+        qWarning() << "dock ui root is not an item";
+        delete m_uiIncubator->object();
+        return;
+    }
+
+    QQmlEngine::setObjectOwnership(m_uiRoot, QQmlEngine::CppOwnership);
+
+    if (rootObject()) {
+        rootObject()->setProperty("ui", QVariant::fromValue(m_uiRoot.data()));
+    }
+
+    //! the window is mapped only with its ui, an empty dock would
+    //! already reserve its struts
+    if (m_mapped) {
+        setVisible(true);
+        syncGeometry();
+    }
+
+    emit uiReady();
+}
+
+bool DockView::isUiReady() const
+{
+    return !m_uiRoot.isNull();
+}
+
+void DockView::setMapped(bool mapped)
+{
+    m_mapped = mapped;
+
+    if (!mapped) {
+        setVisible(false);
+    } else if (isUiReady()) {
+        setVisible(true);
+        syncGeometry();
+    }
 }
 
 bool DockView::setCurrentScreen(const QString id)
 {
     QScreen *nextScreen{qGuiApp->primaryScreen()};
+    auto *dockCorona = qobject_cast<DockCorona *>(this->corona());
 
-    if (id != "primary") {
-        foreach (auto scr, qGuiApp->screens()) {
-            if (scr && scr->name() == id) {
-                nextScreen = scr;
-                break;
-            }
+    if (id != "primary" && dockCorona) {
+        if (QScreen *scr = dockCorona->screenPool()->screen(id)) {
+            nextScreen = scr;
         }
     }
 
@@ -213,8 +332,6 @@ bool DockView::setCurrentScreen(const QString id)
     }
 
     if (nextScreen) {
-        auto *dockCorona = qobject_cast<DockCorona *>(this->corona());
-
         if (dockCorona) {
             auto freeEdges = dockCorona->freeEdges(nextScreen);
 
@@ -245,8 +362,9 @@ void DockView::setScreenToFollow(QScreen *screen, bool updateScreenId)
 
     m_screenToFollow = screen;
 
-    if (updateScreenId) {
+    if (updateScreenId && m_screenToFollowId != screen->name()) {
         m_screenToFollowId = screen->name();
+        emit currentScreenChanged();
     }
 
     qDebug() << "adapting to screen...";
@@ -265,18 +383,11 @@ void DockView::reconsiderScreen()
 {
     qDebug() << "  Delayer  ";
 
-    foreach (auto scr, qGuiApp->screens()) {
-        qDebug() << "      D, found screen: " << scr->name();
-    }
-
     auto *dockCorona = qobject_cast<DockCorona *>(this->corona());
-    bool screenExists{false};
 
     //!check if the associated screen is running
-    foreach (auto scr, qGuiApp->screens()) {
-        if (m_screenToFollowId == scr->name())
-            screenExists = true;
-    }
+    QScreen *followScreen = dockCorona->screenPool()->screen(m_screenToFollowId);
+    bool screenExists = (followScreen != nullptr);
 
     qDebug() << "dock screen exists  ::: " << screenExists;
 
@@ -304,12 +415,10 @@ void DockView::reconsiderScreen()
         //! 3.an explicit dock must be always on the correct associated screen
         //! there are cases that window manager misplaces the dock, this function
         //! ensures that this dock will return at its correct screen
-        foreach (auto scr, qGuiApp->screens()) {
-            if (scr && scr->name() == m_screenToFollowId) {
-                connect(scr, &QScreen::geometryChanged, this, &DockView::screenGeometryChanged);
-                setScreenToFollow(scr);
-                syncGeometry();
-            }
+        if (followScreen) {
+            connect(followScreen, &QScreen::geometryChanged, this, &DockView::screenGeometryChanged, Qt::UniqueConnection);
+            setScreenToFollow(followScreen);
+            syncGeometry();
         }
     }
 
@@ -1111,6 +1220,76 @@ void DockView::closeApplication()
         dockCorona->closeApplication();
 }
 
+bool DockView::resourcesReleased() const
+{
+    return m_resourcesReleased;
+}
+
+QVariantMap DockView::memoryTrimStatistics() const
+{
+    QVariantMap statistics;
+    statistics[QStringLiteral("resourcesReleased")] = m_resourcesReleased;
+    statistics[QStringLiteral("trims")] = m_memoryTrims;
+    statistics[QStringLiteral("residentBefore")] = m_residentBeforeTrim;
+    statistics[QStringLiteral("residentAfter")] = m_residentAfterTrim;
+
+    return statistics;
+}
+
+void DockView::updateIdleTrim()
+{
+    auto *dockCorona = qobject_cast<DockCorona *>(this->corona());
+    const int delay = dockCorona ? dockCorona->globalSettings()->idleTrimDelay() : 0;
+
+    if (m_visibility && m_visibility->isHidden()) {
+        if (delay > 0 && !m_resourcesReleased) {
+            m_idleTrimTimer.start(delay * 60 * 1000);
+        } else if (delay == 0) {
+            m_idleTrimTimer.stop();
+        }
+
+        return;
+    }
+
+    m_idleTrimTimer.stop();
+
+    if (m_resourcesReleased) {
+        //! the released resources are created again by the next frames
+        m_resourcesReleased = false;
+        emit resourcesReleasedChanged();
+        update();
+    }
+}
+
+void DockView::releaseIdleResources()
+{
+    if (m_resourcesReleased || !m_visibility || !m_visibility->isHidden()) {
+        return;
+    }
+
+    m_residentBeforeTrim = residentMemory();
+
+    //! the layer effects are unloaded from qml and their FBOs are freed
+    m_resourcesReleased = true;
+    emit resourcesReleasedChanged();
+
+    //! the engine and the pixmap cache are shared with the other docks,
+    //! their caches are not evicted here, only garbage is collected
+    engine()->collectGarbage();
+    releaseResources();
+    update();
+
+    //! the scene graph frees the textures of the removed items in its next sync
+    QTimer::singleShot(1000, this, [this]() {
+#ifdef __GLIBC__
+        malloc_trim(0);
+#endif
+        ++m_memoryTrims;
+        m_residentAfterTrim = residentMemory();
+        qDebug() << "dock resources released, resident memory" << m_residentBeforeTrim << "->" << m_residentAfterTrim << "KiB";
+    });
+}
+
 void DockView::deactivateApplets()
 {
     if (!containment()) {
@@ -1233,7 +1412,8 @@ void DockView::mousePressEvent(QMouseEvent *event)
                     auto systrayId = applet->config().readEntry("SystrayContainmentId");
                     applet = 0;
                     inSystray = true;
-                    Plasma::Containment *cont = containmentById(systrayId.toInt());
+                    auto *dockCorona = qobject_cast<DockCorona *>(this->corona());
+                    Plasma::Containment *cont = dockCorona ? dockCorona->containmentById(systrayId.toUInt()) : nullptr;
 
                     if (cont) {
                         foreach (Plasma::Applet *appletCont, cont->applets()) {
@@ -1479,17 +1659,6 @@ void DockView::addContainmentActions(QMenu *desktopMenu, QEvent *event)
     return;
 }
 
-Plasma::Containment *DockView::containmentById(uint id)
-{
-    foreach (auto containment, corona()->containments()) {
-        if (id == containment->id()) {
-            return containment;
-        }
-    }
-
-    return 0;
-}
-
 //!END overriding context menus behavior
 
 //!BEGIN draw panel shadows outside the dock window
@@ -32,6 +32,7 @@
 #include <QScreen>
 #include <QPointer>
 #include <QTimer>
+#include <QVariantMap>
 
 #include <Plasma/Theme>
 
@@ -41,14 +42,20 @@ class Corona;
 class Containment;
 }
 
+class QQmlComponent;
+class QQuickItem;
+
 namespace Latte {
 
+class UiIncubator;
+
 class DockView : public PlasmaQuick::ContainmentView {
     Q_OBJECT
     Q_PROPERTY(bool dockWinBehavior READ dockWinBehavior WRITE setDockWinBehavior NOTIFY dockWinBehaviorChanged)
     Q_PROPERTY(bool drawShadows READ drawShadows WRITE setDrawShadows NOTIFY drawShadowsChanged)
     Q_PROPERTY(bool drawEffects READ drawEffects WRITE setDrawEffects NOTIFY drawEffectsChanged)
     Q_PROPERTY(bool onPrimary READ onPrimary WRITE setOnPrimary NOTIFY onPrimaryChanged)
+    Q_PROPERTY(bool resourcesReleased READ resourcesReleased NOTIFY resourcesReleasedChanged)
 
     Q_PROPERTY(int alignment READ alignment WRITE setAlignment NOTIFY alignmentChanged)
     Q_PROPERTY(int docksCount READ docksCount NOTIFY docksCountChanged)
@@ -145,6 +152,16 @@ public:
 
     void deactivateApplets();
 
+    //! the dock ui is incubated asynchronously while the docks are loaded
+    bool isUiReady() const;
+    //! shows the window once its ui is ready, or hides it
+    void setMapped(bool mapped);
+
+    //! the resources of the dock are released while it stays hidden
+    bool resourcesReleased() const;
+    //! the resident memory in KiB before and after the last release
+    QVariantMap memoryTrimStatistics() const;
+
     QQmlListProperty<QScreen> screens();
     static int countScreens(QQmlListProperty<QScreen> *property);
     static QScreen *atScreens(QQmlListProperty<QScreen> *property, int index);
@@ -183,6 +200,7 @@ signals:
     void currentScreenChanged();
     void dockLocationChanged();
     void docksCountChanged();
+    void freeEdgesChanged();
     void dockWinBehaviorChanged();
     void drawShadowsChanged();
     void drawEffectsChanged();
@@ -200,11 +218,13 @@ signals:
     void maskAreaChanged();
     void screenGeometryChanged();
     void sessionChanged();
+    void resourcesReleasedChanged();
     void shadowChanged();
     void xChanged();
     void yChanged();
 
     void absGeometryChanged(const QRect &geometry);
+    void uiReady();
 
 private slots:
     void menuAboutToHide();
@@ -213,6 +233,11 @@ private slots:
     void updateEffects();
 
     void restoreConfig();
+
+    void createUi();
+
+    void updateIdleTrim();
+    void releaseIdleResources();
     void saveConfig();
 
 private:
@@ -221,20 +246,26 @@ private:
     void updatePosition(QRect availableScreenRect = QRect());
     void updateFormFactor();
 
+    void uiIncubated();
+
     QRect maximumNormalGeometry();
 
 private:
-    Plasma::Containment *containmentById(uint id);
 
     bool m_forceDrawCenteredBorders{false};
     bool m_dockWinBehavior{false};
     bool m_drawShadows{false};
     bool m_drawEffects{false};
     bool m_onPrimary{true};
+    bool m_mapped{false};
+    bool m_resourcesReleased{false};
     int m_maxThickness{24};
     int m_normalThickness{24};
     int m_offset{0};
     int m_shadow{0};
+    int m_memoryTrims{0};
+    int m_residentBeforeTrim{0};
+    int m_residentAfterTrim{0};
     float m_maxLength{1};
 
     Dock::Alignment m_alignment{Dock::Center};
@@ -248,9 +279,13 @@ private:
     QPointer<PlasmaQuick::ConfigView> m_configView;
     QPointer<VisibilityManager> m_visibility;
     QPointer<QScreen> m_screenToFollow;
+    QPointer<QQuickItem> m_uiRoot;
+    QQmlComponent *m_uiComponent{nullptr};
+    UiIncubator *m_uiIncubator{nullptr};
     QString m_screenToFollowId;
 
     QTimer m_screenSyncTimer;
+    QTimer m_idleTrimTimer;
 
     Plasma::Theme m_theme;
     //only for the mask on disabled compositing, not to actually paint
@@ -258,6 +293,8 @@ private:
 
     //only for the mask, not to actually paint
     Plasma::FrameSvg::EnabledBorders m_enabledBorders = Plasma::FrameSvg::AllBorders;
+
+    friend class UiIncubator;
 };
 
 }
@@ -32,6 +32,7 @@ GlobalSettings::GlobalSettings(QObject *parent)
         m_altSessionAction->setCheckable(true);
         connect(m_altSessionAction, &QAction::triggered, this, &GlobalSettings::enableAltSession);
         connect(m_corona, &DockCorona::currentSessionChanged, this, &GlobalSettings::currentSessionChangedSlot);
+        connect(m_corona, &DockCorona::standbyMemoryCostChanged, this, &GlobalSettings::standbyMemoryCostChanged);
     }
 }
 
@@ -66,6 +67,63 @@ void GlobalSettings::setExposeAltSession(bool state)
     emit exposeAltSessionChanged();
 }
 
+bool GlobalSettings::keepSessionsLoaded() const
+{
+    return m_keepSessionsLoaded;
+}
+
+void GlobalSettings::setKeepSessionsLoaded(bool state)
+{
+    if (m_keepSessionsLoaded == state) {
+        return;
+    }
+
+    m_keepSessionsLoaded = state;
+    save();
+    emit keepSessionsLoadedChanged();
+}
+
+int GlobalSettings::standbyMemoryCost() const
+{
+    return m_corona ? m_corona->standbyMemoryCost() : 0;
+}
+
+int GlobalSettings::launcherEntryRate() const
+{
+    return m_launcherEntryRate;
+}
+
+void GlobalSettings::setLauncherEntryRate(int rate)
+{
+    rate = qBound(1, rate, 60);
+
+    if (m_launcherEntryRate == rate) {
+        return;
+    }
+
+    m_launcherEntryRate = rate;
+    save();
+    emit launcherEntryRateChanged();
+}
+
+int GlobalSettings::idleTrimDelay() const
+{
+    return m_idleTrimDelay;
+}
+
+void GlobalSettings::setIdleTrimDelay(int minutes)
+{
+    minutes = qBound(0, minutes, 24 * 60);
+
+    if (m_idleTrimDelay == minutes) {
+        return;
+    }
+
+    m_idleTrimDelay = minutes;
+    save();
+    emit idleTrimDelayChanged();
+}
+
 void GlobalSettings::currentSessionChangedSlot(Dock::SessionType type)
 {
     if (m_corona->currentSession() == Dock::DefaultSession)
@@ -121,11 +179,17 @@ void GlobalSettings::setCurrentSession(Dock::SessionType session)
 void GlobalSettings::load()
 {
     setExposeAltSession(m_configGroup.readEntry("exposeAltSession", false));
+    setKeepSessionsLoaded(m_configGroup.readEntry("keepSessionsLoaded", false));
+    setLauncherEntryRate(m_configGroup.readEntry("launcherEntryRate", 10));
+    setIdleTrimDelay(m_configGroup.readEntry("idleTrimDelay", 10));
 }
 
 void GlobalSettings::save()
 {
     m_configGroup.writeEntry("exposeAltSession", m_exposeAltSession);
+    m_configGroup.writeEntry("keepSessionsLoaded", m_keepSessionsLoaded);
+    m_configGroup.writeEntry("launcherEntryRate", m_launcherEntryRate);
+    m_configGroup.writeEntry("idleTrimDelay", m_idleTrimDelay);
     m_configGroup.sync();
 }
 //!END configuration functions
@@ -38,6 +38,10 @@ class GlobalSettings : public QObject {
     Q_OBJECT
     Q_PROPERTY(bool autostart READ autostart WRITE setAutostart NOTIFY autostartChanged)
     Q_PROPERTY(bool exposeAltSession READ exposeAltSession WRITE setExposeAltSession NOTIFY exposeAltSessionChanged)
+    Q_PROPERTY(bool keepSessionsLoaded READ keepSessionsLoaded WRITE setKeepSessionsLoaded NOTIFY keepSessionsLoadedChanged)
+    Q_PROPERTY(int standbyMemoryCost READ standbyMemoryCost NOTIFY standbyMemoryCostChanged)
+    Q_PROPERTY(int launcherEntryRate READ launcherEntryRate WRITE setLauncherEntryRate NOTIFY launcherEntryRateChanged)
+    Q_PROPERTY(int idleTrimDelay READ idleTrimDelay WRITE setIdleTrimDelay NOTIFY idleTrimDelayChanged)
 
     Q_PROPERTY(Latte::Dock::SessionType currentSession READ currentSession WRITE setCurrentSession NOTIFY currentSessionChanged)
 
@@ -56,6 +60,21 @@ public:
     void setExposeAltSession(bool state);
     QAction *altSessionAction() const;
 
+    //! the docks of the other session stay loaded but hidden
+    bool keepSessionsLoaded() const;
+    void setKeepSessionsLoaded(bool state);
+    //! the memory in KiB that the docks of the other session take or would take
+    int standbyMemoryCost() const;
+
+    //! the progress updates per second that are accepted from each application
+    int launcherEntryRate() const;
+    void setLauncherEntryRate(int rate);
+
+    //! the minutes that a dock stays hidden before its resources are released, 0 never.
+    //! only the window resources and layer effects of that dock are released
+    int idleTrimDelay() const;
+    void setIdleTrimDelay(int minutes);
+
     Latte::Dock::SessionType currentSession() const;
     void setCurrentSession(Latte::Dock::SessionType session);
 
@@ -68,6 +87,10 @@ signals:
     void currentSessionChanged();
     void autostartChanged();
     void exposeAltSessionChanged();
+    void keepSessionsLoadedChanged();
+    void launcherEntryRateChanged();
+    void idleTrimDelayChanged();
+    void standbyMemoryCostChanged();
 
 private slots:
     void currentSessionChangedSlot(Dock::SessionType type);
@@ -77,6 +100,9 @@ private:
     void save();
 
     bool m_exposeAltSession{false};
+    bool m_keepSessionsLoaded{false};
+    int m_launcherEntryRate{10};
+    int m_idleTrimDelay{10};
     QAction *m_altSessionAction{nullptr};
     DockCorona *m_corona{nullptr};
     QPointer<QFileDialog> m_fileDialog;
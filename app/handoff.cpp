@@ -0,0 +1,214 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "handoff.h"
+#include "dockcorona.h"
+
+#include <algorithm>
+
+#include <QGuiApplication>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QLockFile>
+
+namespace Latte {
+
+//! the messages are single lines, the reply carries the state in base64
+const QByteArray HandoffRequest = QByteArrayLiteral("handoff");
+const QByteArray ReadyReply = QByteArrayLiteral("ready");
+const QByteArray FirstFrameMessage = QByteArrayLiteral("first-frame");
+
+//! the time that the new instance waits for the running one
+constexpr int HandoffTimeout = 5000;
+
+namespace {
+
+QString serverName()
+{
+    return QDir::tempPath() + QStringLiteral("/latte-dock-handoff");
+}
+
+//! the unique name that KDBusService registered, e.g. org.kde.lattedock
+QString dbusServiceName()
+{
+    QStringList parts = QCoreApplication::organizationDomain().split(QLatin1Char('.'), QString::SkipEmptyParts);
+    std::reverse(parts.begin(), parts.end());
+    parts << QCoreApplication::applicationName();
+
+    return parts.join(QLatin1Char('.'));
+}
+
+}
+
+HandoffServer::HandoffServer(DockCorona *corona, QLockFile *lockFile, QObject *parent)
+    : QObject(parent),
+      m_server(new QLocalServer(this)),
+      m_lockFile(lockFile),
+      m_corona(corona)
+{
+    //! a previous instance that crashed leaves its socket behind
+    QLocalServer::removeServer(serverName());
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+
+    if (!m_server->listen(serverName())) {
+        qWarning() << "handoff server can not listen:" << m_server->errorString();
+        return;
+    }
+
+    connect(m_server, &QLocalServer::newConnection, this, &HandoffServer::newConnection);
+}
+
+HandoffServer::~HandoffServer()
+{
+}
+
+void HandoffServer::newConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        //! only one replacement at a time
+        if (m_client) {
+            socket->deleteLater();
+            continue;
+        }
+
+        m_client = socket;
+        connect(socket, &QLocalSocket::readyRead, this, &HandoffServer::readRequest);
+        connect(socket, &QLocalSocket::disconnected, this, &HandoffServer::clientDisconnected);
+    }
+}
+
+void HandoffServer::readRequest()
+{
+    while (m_client && m_client->canReadLine()) {
+        const QByteArray message = m_client->readLine().trimmed();
+
+        if (!m_handedOff && message == HandoffRequest) {
+            qDebug() << "handoff requested";
+
+            m_corona->prepareHandoff();
+            m_lockFile->unlock();
+            //! otherwise the unique service of the new instance exits
+            QDBusConnection::sessionBus().unregisterService(dbusServiceName());
+            m_handedOff = true;
+
+            QByteArray state;
+            QDataStream stream(&state, QIODevice::WriteOnly);
+            stream << m_corona->handoffState();
+
+            m_client->write(ReadyReply + ' ' + state.toBase64() + '\n');
+            m_client->flush();
+        } else if (m_handedOff && message == FirstFrameMessage) {
+            qDebug() << "handoff finished, the new instance is visible";
+            m_replaced = true;
+            qGuiApp->exit();
+        }
+    }
+}
+
+void HandoffServer::clientDisconnected()
+{
+    if (m_client) {
+        m_client->deleteLater();
+    }
+
+    if (!m_handedOff || m_replaced) {
+        return;
+    }
+
+    //! the new instance went away before its docks were shown
+    if (m_lockFile->tryLock(0)) {
+        qWarning() << "handoff failed, resuming";
+        m_handedOff = false;
+        QDBusConnection::sessionBus().registerService(dbusServiceName());
+        m_corona->resumeAfterHandoff();
+    } else {
+        //! the new instance is running, only its notification was lost
+        qGuiApp->exit();
+    }
+}
+
+HandoffClient::HandoffClient(QObject *parent)
+    : QObject(parent),
+      m_socket(new QLocalSocket(this))
+{
+}
+
+HandoffClient::~HandoffClient()
+{
+}
+
+bool HandoffClient::request()
+{
+    m_socket->connectToServer(serverName());
+
+    if (!m_socket->waitForConnected(HandoffTimeout)) {
+        return false;
+    }
+
+    m_socket->write(HandoffRequest + '\n');
+
+    if (!m_socket->waitForBytesWritten(HandoffTimeout)) {
+        return false;
+    }
+
+    while (!m_socket->canReadLine()) {
+        if (!m_socket->waitForReadyRead(HandoffTimeout)) {
+            m_socket->abort();
+            return false;
+        }
+    }
+
+    const QByteArray reply = m_socket->readLine().trimmed();
+    const int separator = reply.indexOf(' ');
+
+    if (reply.left(separator) != ReadyReply) {
+        return false;
+    }
+
+    //! the docks start cold without the state, the handoff still works
+    if (separator > 0) {
+        QDataStream stream(QByteArray::fromBase64(reply.mid(separator + 1)));
+        stream >> m_state;
+    }
+
+    return true;
+}
+
+QVariantMap HandoffClient::state() const
+{
+    return m_state;
+}
+
+void HandoffClient::firstFrame()
+{
+    if (m_socket->state() != QLocalSocket::ConnectedState) {
+        return;
+    }
+
+    m_socket->write(FirstFrameMessage + '\n');
+    m_socket->flush();
+}
+
+}
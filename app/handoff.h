@@ -0,0 +1,98 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HANDOFF_H
+#define HANDOFF_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVariantMap>
+
+class QLocalServer;
+class QLocalSocket;
+class QLockFile;
+
+namespace Latte {
+
+class DockCorona;
+
+/**
+ * @brief The handoff of a running latte-dock to the one that replaces it
+ * with --replace.
+ *
+ * The new instance asks the running one over a local socket to hand off.
+ * The running one saves its state the way it does at shutdown: the screen
+ * pool, the layout cache and the dock snapshots, and the icon cache is
+ * already on disk. The state that is not saved, the visibility of its docks
+ * and the colors of its icons, is sent with the reply. It releases the lock
+ * and keeps its docks on screen until the new instance reports the first
+ * frame of its docks, then it exits. If the new instance goes away before
+ * that, it resumes.
+ *
+ * --import does not hand off, the running instance would write its
+ * configuration over the imported one.
+ */
+class HandoffServer : public QObject {
+    Q_OBJECT
+
+public:
+    HandoffServer(DockCorona *corona, QLockFile *lockFile, QObject *parent = nullptr);
+    ~HandoffServer() override;
+
+private:
+    void newConnection();
+    void readRequest();
+    void clientDisconnected();
+
+    bool m_handedOff{false};
+    bool m_replaced{false};
+
+    QLocalServer *m_server{nullptr};
+    QPointer<QLocalSocket> m_client;
+    QLockFile *m_lockFile{nullptr};
+    DockCorona *m_corona{nullptr};
+};
+
+class HandoffClient : public QObject {
+    Q_OBJECT
+
+public:
+    HandoffClient(QObject *parent = nullptr);
+    ~HandoffClient() override;
+
+    //! asks the running instance to hand off and waits until it has released
+    //! the lock, false when there is no running instance that supports it
+    bool request();
+
+    //! the state that the running instance sent with its reply
+    QVariantMap state() const;
+
+public slots:
+    //! the first frame of the docks was rendered, the old instance exits
+    void firstFrame();
+
+private:
+    QLocalSocket *m_socket{nullptr};
+    QVariantMap m_state;
+};
+
+}
+
+#endif // HANDOFF_H
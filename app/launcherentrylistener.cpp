@@ -0,0 +1,199 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "launcherentrylistener.h"
+#include "dockitemupdates.h"
+
+#include <QDBusConnection>
+#include <QDebug>
+#include <QtMath>
+
+namespace Latte {
+
+LauncherEntryListener::LauncherEntryListener(DockItemUpdateQueue *updates, QObject *parent)
+    : QObject(parent),
+      m_updates(updates)
+{
+    m_pendingTimer.setSingleShot(true);
+    m_pendingTimer.setInterval(progressInterval());
+    connect(&m_pendingTimer, &QTimer::timeout, this, &LauncherEntryListener::flushPending);
+
+    //! the applications broadcast the signal, any sender and path is accepted
+    bool connected = QDBusConnection::sessionBus().connect(QString(), QString()
+                     , QStringLiteral("com.canonical.Unity.LauncherEntry"), QStringLiteral("Update")
+                     , this, SLOT(update(QString, QVariantMap)));
+
+    if (!connected) {
+        qWarning() << "LauncherEntry Update signals can not be received";
+    }
+}
+
+LauncherEntryListener::~LauncherEntryListener()
+{
+    QDBusConnection::sessionBus().disconnect(QString(), QString()
+            , QStringLiteral("com.canonical.Unity.LauncherEntry"), QStringLiteral("Update")
+            , this, SLOT(update(QString, QVariantMap)));
+}
+
+int LauncherEntryListener::progressRate() const
+{
+    return m_progressRate;
+}
+
+void LauncherEntryListener::setProgressRate(int rate)
+{
+    m_progressRate = qBound(1, rate, 60);
+    m_pendingTimer.setInterval(progressInterval());
+}
+
+int LauncherEntryListener::progressLength() const
+{
+    return m_progressLength;
+}
+
+void LauncherEntryListener::setProgressLength(int pixels)
+{
+    m_progressLength = qMax(1, pixels);
+}
+
+int LauncherEntryListener::progressInterval() const
+{
+    return 1000 / m_progressRate;
+}
+
+void LauncherEntryListener::update(const QString &uri, const QVariantMap &properties)
+{
+    QString identifier = uri;
+
+    if (identifier.startsWith(QLatin1String("application://"))) {
+        identifier.remove(0, 14);
+    }
+
+    if (identifier.endsWith(QLatin1String(".desktop"))) {
+        identifier.chop(8);
+    }
+
+    if (identifier.isEmpty()) {
+        return;
+    }
+
+    Entry &entry = m_entries[identifier];
+
+    DockItemUpdate update;
+    update.identifier = identifier;
+    update.fields = DockItemUpdate::NoField;
+
+    if (properties.contains(QStringLiteral("count")) || properties.contains(QStringLiteral("count-visible"))) {
+        entry.count = properties.value(QStringLiteral("count"), entry.count).toLongLong();
+        entry.countVisible = properties.value(QStringLiteral("count-visible"), entry.countVisible).toBool();
+
+        update.badge = entry.countVisible && entry.count > 0 ? QString::number(entry.count) : QString();
+        update.fields |= DockItemUpdate::BadgeField;
+    }
+
+    if (properties.contains(QStringLiteral("urgent"))) {
+        update.urgent = properties.value(QStringLiteral("urgent")).toBool();
+        update.fields |= DockItemUpdate::UrgentField;
+    }
+
+    if (update.fields != DockItemUpdate::NoField) {
+        m_updates->enqueue(update);
+    }
+
+    if (properties.contains(QStringLiteral("progress")) || properties.contains(QStringLiteral("progress-visible"))) {
+        entry.progress = qBound(0.0, properties.value(QStringLiteral("progress"), entry.progress).toDouble(), 1.0);
+        entry.progressVisible = properties.value(QStringLiteral("progress-visible"), entry.progressVisible).toBool();
+
+        if (!isVisibleChange(entry)) {
+            entry.progressPending = false;
+        } else if (!entry.progressVisible || entry.deliveredProgress < 0 || entry.progress >= 1.0
+                   || !entry.lastProgress.isValid() || entry.lastProgress.elapsed() >= progressInterval()) {
+            //! showing, hiding and completing are never delayed
+            deliverProgress(identifier, entry);
+        } else {
+            entry.progressPending = true;
+
+            if (!m_pendingTimer.isActive()) {
+                m_pendingTimer.start();
+            }
+        }
+    }
+
+    if (!entry.countVisible && !entry.progressVisible
+        && entry.deliveredProgress < 0 && !entry.progressPending) {
+        m_entries.remove(identifier);
+    }
+}
+
+bool LauncherEntryListener::isVisibleChange(const Entry &entry) const
+{
+    if (!entry.progressVisible) {
+        return entry.deliveredProgress >= 0;
+    }
+
+    if (entry.deliveredProgress < 0) {
+        return true;
+    }
+
+    //! the dock items show the progress in percents
+    if (qRound(entry.progress * 100) == qRound(entry.deliveredProgress * 100)) {
+        return false;
+    }
+
+    return entry.progress >= 1.0
+           || qAbs(entry.progress - entry.deliveredProgress) * m_progressLength >= 1.0;
+}
+
+void LauncherEntryListener::deliverProgress(const QString &identifier, Entry &entry)
+{
+    DockItemUpdate update;
+    update.identifier = identifier;
+    update.fields = DockItemUpdate::ProgressField;
+    update.progress = entry.progressVisible ? qRound(entry.progress * 100) : -1;
+
+    entry.deliveredProgress = entry.progressVisible ? entry.progress : -1;
+    entry.progressPending = false;
+    entry.lastProgress.start();
+
+    m_updates->enqueue(update);
+}
+
+void LauncherEntryListener::flushPending()
+{
+    bool waiting{false};
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (!it->progressPending) {
+            continue;
+        }
+
+        if (it->lastProgress.elapsed() >= progressInterval()) {
+            deliverProgress(it.key(), *it);
+        } else {
+            waiting = true;
+        }
+    }
+
+    if (waiting) {
+        m_pendingTimer.start();
+    }
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAUNCHERENTRYLISTENER_H
+#define LAUNCHERENTRYLISTENER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+
+namespace Latte {
+
+class DockItemUpdateQueue;
+
+/**
+ * @brief The LauncherEntryListener class, listens to the
+ * com.canonical.Unity.LauncherEntry Update signals of the applications and
+ * feeds their count, progress and urgent hints to the dock item updates.
+ *
+ * Progress is rate limited for each application and the values that would
+ * not move the progress circle by at least one pixel are skipped.
+ */
+class LauncherEntryListener : public QObject {
+    Q_OBJECT
+
+public:
+    LauncherEntryListener(DockItemUpdateQueue *updates, QObject *parent = nullptr);
+    ~LauncherEntryListener() override;
+
+    //! the progress updates delivered per second for each application
+    int progressRate() const;
+    void setProgressRate(int rate);
+
+    //! the length in pixels of the largest progress circle
+    int progressLength() const;
+    void setProgressLength(int pixels);
+
+private slots:
+    void update(const QString &uri, const QVariantMap &properties);
+
+private:
+    struct Entry {
+        qint64 count{0};
+        bool countVisible{false};
+        double progress{0};
+        bool progressVisible{false};
+
+        //! the progress that was sent last, -1 when it is hidden
+        double deliveredProgress{ -1};
+        //! a progress that waits for its slot
+        bool progressPending{false};
+        QElapsedTimer lastProgress;
+    };
+
+    void deliverProgress(const QString &identifier, Entry &entry);
+    void flushPending();
+    bool isVisibleChange(const Entry &entry) const;
+    int progressInterval() const;
+
+    int m_progressRate{10};
+    int m_progressLength{100};
+
+    //! identifier -> the last known state of the application
+    QHash<QString, Entry> m_entries;
+
+    QTimer m_pendingTimer;
+    DockItemUpdateQueue *m_updates{nullptr};
+};
+
+}
+
+#endif // LAUNCHERENTRYLISTENER_H
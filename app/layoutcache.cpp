@@ -0,0 +1,275 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "layoutcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+
+#include <cstring>
+
+namespace Latte {
+
+namespace LayoutCache {
+
+namespace {
+
+//! the file is written and read by the same machine, the records are
+//! stored in native byte order and every change of them needs a new version
+const char Magic[4] = {'L', 'T', 'L', 'C'};
+const quint32 Version = 1;
+
+struct Header {
+    char magic[4];
+    quint32 version;
+    qint64 configModified;
+    qint64 configSize;
+    quint32 containments;
+    quint32 applets;
+    quint32 stringsSize;
+    quint32 reserved;
+};
+
+struct ContainmentRecord {
+    quint32 id;
+    qint32 lastScreen;
+    qint32 location;
+    qint32 session;
+    quint32 onPrimary;
+    quint32 plugin;
+    quint32 pluginSize;
+    quint32 firstApplet;
+    quint32 applets;
+};
+
+struct AppletRecord {
+    quint32 id;
+    quint32 plugin;
+    quint32 pluginSize;
+};
+
+struct ConfigStamp {
+    qint64 modified{ -1};
+    qint64 size{ -1};
+};
+
+ConfigStamp configStamp(const QString &configFile)
+{
+    ConfigStamp stamp;
+    const QFileInfo info(configFile);
+
+    if (info.exists()) {
+        stamp.modified = info.lastModified().toMSecsSinceEpoch();
+        stamp.size = info.size();
+    }
+
+    return stamp;
+}
+
+//! the strings table, the plugin names are stored once
+class Strings {
+public:
+    quint32 add(const QString &text, quint32 &size) {
+        const QByteArray utf8 = text.toUtf8();
+        size = static_cast<quint32>(utf8.size());
+
+        if (!m_offsets.contains(utf8)) {
+            m_offsets[utf8] = static_cast<quint32>(m_data.size());
+            m_data.append(utf8);
+        }
+
+        return m_offsets.value(utf8);
+    }
+
+    const QByteArray &data() const {
+        return m_data;
+    }
+
+private:
+    QByteArray m_data;
+    QHash<QByteArray, quint32> m_offsets;
+};
+
+}
+
+QString cacheFile(const QString &configFile)
+{
+    const QByteArray hash = QCryptographicHash::hash(QFileInfo(configFile).absoluteFilePath().toUtf8(), QCryptographicHash::Md5);
+
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+           + QStringLiteral("/layouts/") + QString::fromLatin1(hash.toHex()) + QStringLiteral(".cache");
+}
+
+bool read(const QString &cacheFile, const QString &configFile, QList<ContainmentInfo> &containments)
+{
+    const ConfigStamp stamp = configStamp(configFile);
+
+    if (stamp.modified < 0) {
+        return false;
+    }
+
+    QFile file(cacheFile);
+
+    if (!file.open(QIODevice::ReadOnly) || file.size() < static_cast<qint64>(sizeof(Header))) {
+        return false;
+    }
+
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+
+    if (!data) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+
+    const qint64 expectedSize = static_cast<qint64>(sizeof(Header))
+                                + static_cast<qint64>(header.containments) * sizeof(ContainmentRecord)
+                                + static_cast<qint64>(header.applets) * sizeof(AppletRecord)
+                                + header.stringsSize;
+
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version
+        || header.configModified != stamp.modified || header.configSize != stamp.size
+        || expectedSize != size) {
+        file.unmap(const_cast<uchar *>(data));
+        return false;
+    }
+
+    const auto *containmentRecords = reinterpret_cast<const ContainmentRecord *>(data + sizeof(Header));
+    const auto *appletRecords = reinterpret_cast<const AppletRecord *>(containmentRecords + header.containments);
+    const auto *strings = reinterpret_cast<const char *>(appletRecords + header.applets);
+
+    const auto string = [&](quint32 offset, quint32 size, bool &valid) {
+        if (static_cast<quint64>(offset) + size > header.stringsSize) {
+            valid = false;
+            return QString();
+        }
+
+        return QString::fromUtf8(strings + offset, static_cast<int>(size));
+    };
+
+    bool valid{true};
+    QList<ContainmentInfo> result;
+    result.reserve(static_cast<int>(header.containments));
+
+    for (quint32 i = 0; i < header.containments && valid; ++i) {
+        const ContainmentRecord &record = containmentRecords[i];
+
+        if (static_cast<quint64>(record.firstApplet) + record.applets > header.applets) {
+            valid = false;
+            break;
+        }
+
+        ContainmentInfo info;
+        info.id = record.id;
+        info.plugin = string(record.plugin, record.pluginSize, valid);
+        info.lastScreen = record.lastScreen;
+        info.onPrimary = record.onPrimary != 0;
+        info.location = static_cast<Plasma::Types::Location>(record.location);
+        info.session = static_cast<Dock::SessionType>(record.session);
+
+        for (quint32 j = record.firstApplet; j < record.firstApplet + record.applets; ++j) {
+            info.applets[appletRecords[j].id] = string(appletRecords[j].plugin, appletRecords[j].pluginSize, valid);
+        }
+
+        result << info;
+    }
+
+    file.unmap(const_cast<uchar *>(data));
+
+    if (!valid) {
+        qWarning() << "layout cache is corrupted:" << cacheFile;
+        return false;
+    }
+
+    containments = result;
+
+    return true;
+}
+
+bool write(const QString &cacheFile, const QString &configFile, const QList<ContainmentInfo> &containments)
+{
+    const ConfigStamp stamp = configStamp(configFile);
+
+    if (stamp.modified < 0 || !QDir().mkpath(QFileInfo(cacheFile).absolutePath())) {
+        return false;
+    }
+
+    Strings strings;
+    QVector<ContainmentRecord> containmentRecords;
+    QVector<AppletRecord> appletRecords;
+
+    for (const auto &info : containments) {
+        ContainmentRecord record;
+        record.id = info.id;
+        record.lastScreen = info.lastScreen;
+        record.location = static_cast<qint32>(info.location);
+        record.session = static_cast<qint32>(info.session);
+        record.onPrimary = info.onPrimary ? 1 : 0;
+        record.plugin = strings.add(info.plugin, record.pluginSize);
+        record.firstApplet = static_cast<quint32>(appletRecords.size());
+        record.applets = static_cast<quint32>(info.applets.size());
+
+        for (auto it = info.applets.constBegin(); it != info.applets.constEnd(); ++it) {
+            AppletRecord applet;
+            applet.id = it.key();
+            applet.plugin = strings.add(it.value(), applet.pluginSize);
+            appletRecords << applet;
+        }
+
+        containmentRecords << record;
+    }
+
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.configModified = stamp.modified;
+    header.configSize = stamp.size;
+    header.containments = static_cast<quint32>(containmentRecords.size());
+    header.applets = static_cast<quint32>(appletRecords.size());
+    header.stringsSize = static_cast<quint32>(strings.data().size());
+    header.reserved = 0;
+
+    QSaveFile file(cacheFile);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char *>(containmentRecords.constData()), containmentRecords.size() * sizeof(ContainmentRecord));
+    file.write(reinterpret_cast<const char *>(appletRecords.constData()), appletRecords.size() * sizeof(AppletRecord));
+    file.write(strings.data());
+
+    return file.commit();
+}
+
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAYOUTCACHE_H
+#define LAYOUTCACHE_H
+
+#include "containmentindex.h"
+
+#include <QList>
+#include <QString>
+
+namespace Latte {
+
+/**
+ * @brief The resolved containments of the layout in a binary file, so the
+ * startup does not have to walk the groups of the configuration file.
+ *
+ * The file keeps the modification time and the size of the configuration
+ * file it was created from and it is read with a single mapping. A stale,
+ * truncated or foreign file is rejected and the caller parses the
+ * configuration instead.
+ */
+namespace LayoutCache {
+
+//! the cache file that is used for the layout of that configuration file
+QString cacheFile(const QString &configFile);
+
+//! false when the cache does not exist or does not match the configuration
+bool read(const QString &cacheFile, const QString &configFile, QList<ContainmentInfo> &containments);
+bool write(const QString &cacheFile, const QString &configFile, const QList<ContainmentInfo> &containments);
+
+}
+
+}
+
+#endif // LAYOUTCACHE_H
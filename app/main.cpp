@@ -21,6 +21,8 @@
 #include "dockcorona.h"
 #include "config-latte.h"
 #include "globalsettings.h"
+#include "handoff.h"
+#include "startuptracer.h"
 
 #include <memory>
 #include <csignal>
@@ -32,8 +34,10 @@
 #include <QCommandLineOption>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QLockFile>
 #include <QSharedMemory>
+#include <QTimer>
 
 #include <KLocalizedString>
 #include <KAboutData>
@@ -53,6 +57,9 @@ inline void configureAboutData();
 
 int main(int argc, char **argv)
 {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     //    Devive pixel ratio has some problems in latte (plasmashell) currently.
     //     - dialog continually expands (347951)
     //     - Text element text is screwed (QTBUG-42606)
@@ -63,7 +70,9 @@ int main(int argc, char **argv)
     QCoreApplication::setAttribute(Qt::AA_DisableHighDpiScaling);
 
     QQuickWindow::setDefaultAlphaBuffer(true);
+    const qint64 appBegin = startupTimer.nsecsElapsed() / 1000;
     QApplication app(argc, argv);
+    const qint64 appEnd = startupTimer.nsecsElapsed() / 1000;
     KLocalizedString::setApplicationDomain("latte-dock");
     app.setWindowIcon(QIcon::fromTheme(QStringLiteral("latte-dock")));
 
@@ -79,18 +88,43 @@ int main(int argc, char **argv)
         , {"graphics", i18nc("command line", "Draw boxes around of the applets.")}
         , {"with-window", i18nc("command line", "Open a window with much debug information.")}
         , {"import", i18nc("command line", "Import configuration."), i18nc("command line: import", "file_name")}
+        , {"trace-startup", i18nc("command line", "Write a Chrome trace of the startup (chrome://tracing or Perfetto)."), i18nc("command line: trace-startup", "file_name")}
     });
 
     parser.process(app);
 
+    //! the spans are recorded only when the tracer is installed
+    std::unique_ptr<Latte::StartupTracer> tracer;
+
+    if (parser.isSet(QStringLiteral("trace-startup"))) {
+        tracer.reset(new Latte::StartupTracer(parser.value(QStringLiteral("trace-startup")), startupTimer));
+        tracer->install();
+        tracer->complete("QApplication", "latte", appBegin, appEnd, QString());
+    }
+
     QLockFile lockFile {QDir::tempPath() + "/latte-dock.lock"};
 
     int timeout {100};
+    //! the running instance keeps its docks until the new ones are shown,
+    //! with --import it must exit first or it would write its configuration
+    //! over the imported one
+    std::unique_ptr<Latte::HandoffClient> handoff;
+
     if (parser.isSet(QStringLiteral("replace")) || parser.isSet(QStringLiteral("import"))) {
-        qint64 pid{-1};
-        if (lockFile.getLockInfo(&pid, nullptr, nullptr)) {
-            kill(static_cast<pid_t>(pid), SIGINT);
+        if (!parser.isSet(QStringLiteral("import"))) {
+            handoff.reset(new Latte::HandoffClient);
+        }
+
+        if (handoff && handoff->request()) {
             timeout = 3000;
+        } else {
+            handoff.reset();
+            qint64 pid{-1};
+
+            if (lockFile.getLockInfo(&pid, nullptr, nullptr)) {
+                kill(static_cast<pid_t>(pid), SIGINT);
+                timeout = 3000;
+            }
         }
     }
 
@@ -134,9 +168,33 @@ int main(int argc, char **argv)
     std::signal(SIGKILL, signal_handler);
     std::signal(SIGINT, signal_handler);
 
-    Latte::DockCorona corona;
+    Latte::StartupTrace::Span coronaSpan("DockCorona");
+    Latte::DockCorona corona(handoff ? handoff->state() : QVariantMap());
+    coronaSpan.finish();
     KDBusService service(KDBusService::Unique);
 
+    if (handoff) {
+        QObject::connect(&corona, &Latte::DockCorona::firstDockVisible, handoff.get(), &Latte::HandoffClient::firstFrame);
+        //! when no dock is created there is no first frame, otherwise the
+        //! loader can finish before any dock has rendered
+        QObject::connect(&corona, &Latte::DockCorona::docksLoaded, handoff.get(), [&corona, &handoff]() {
+            if (corona.docksCount() == 0) {
+                handoff->firstFrame();
+            }
+        });
+    }
+
+    Latte::HandoffServer handoffServer(&corona, &lockFile);
+
+    if (tracer) {
+        //! the applets keep initializing after the docks have been created
+        QObject::connect(&corona, &Latte::DockCorona::docksLoaded, &corona, [&tracer]() {
+            QTimer::singleShot(3000, [&tracer]() {
+                tracer->write();
+            });
+        });
+    }
+
     return app.exec();
 }
 
@@ -17,7 +17,11 @@
 */
 
 #include "panelshadows_p.h"
+#include "shmbufferpool.h"
 
+#include <memory>
+
+#include <QCryptographicHash>
 #include <QWindow>
 #include <QPainter>
 
@@ -32,6 +36,13 @@
     #include <fixx11h.h>
 #endif
 
+#if HAVE_XCB_SHM
+    #include <xcb/shm.h>
+    #include <sys/ipc.h>
+    #include <sys/shm.h>
+    #include <cstring>
+#endif
+
 #include <KWayland/Client/connection_thread.h>
 #include <KWayland/Client/registry.h>
 #include <KWayland/Client/shadow.h>
@@ -60,9 +71,15 @@ public:
     }
 
     void freeX11Pixmaps();
+    void releaseUnusedX11Pixmaps();
+#if HAVE_XCB_SHM
+    bool uploadShm(unsigned long pixmap, const QImage &image);
+    void syncShm();
+    void freeShmSegment();
+#endif
     void freeWaylandBuffers();
     void clearPixmaps();
-    void setupPixmaps();
+    bool setupPixmaps();
     Qt::HANDLE createPixmap(const QPixmap &source);
     void initPixmap(const QString &element);
     QPixmap initEmptyPixmap(const QSize &size);
@@ -96,20 +113,61 @@ public:
     //! graphical context
     xcb_gcontext_t _gc;
     bool m_isX11;
+
+    //! the uploaded X pixmaps by the hash of their contents, they are
+    //! shared by all the windows and reused when a theme reload
+    //! creates the same tiles
+    QHash<QByteArray, unsigned long> m_x11Pixmaps;
+#endif
+
+#if HAVE_XCB_SHM
+    //! one shared memory segment reused for all the uploads, the tiles of
+    //! a shadow are written one after the other and synced once
+    struct Shm {
+        bool checked = false;
+        bool available = false;
+        int id = -1;
+        xcb_shm_seg_t segment = 0;
+        uchar *address = nullptr;
+        int size = 0;
+        int used = 0;
+    };
+    Shm m_shm;
 #endif
 
     struct Wayland {
         KWayland::Client::ShadowManager *manager = nullptr;
         KWayland::Client::ShmPool *shmPool = nullptr;
+        //! the tile buffers, painted directly in the shm pool
+        std::unique_ptr<Latte::ShmBufferPool> bufferPool;
 
         QList<KWayland::Client::Buffer::Ptr> shadowBuffers;
+        QList<QByteArray> tileHashes;
     };
     Wayland m_wayland;
 
     QHash<Plasma::FrameSvg::EnabledBorders, QVector<unsigned long>> data;
     QHash<const QWindow *, Plasma::FrameSvg::EnabledBorders> m_windows;
+
+    //! the hash of the rendered tiles and margin hints, a theme reload
+    //! that renders the same shadow does not touch any window
+    QByteArray m_tilesHash;
+    //! the last _KDE_NET_WM_SHADOW value written for each window, with the
+    //! native window it was written to, the X ids are reused by the server
+    QHash<const QWindow *, QPair<WId, QVector<unsigned long>>> m_writtenData;
 };
 
+//! identifies the tile contents, used to reuse the uploaded tiles
+static QByteArray tileHash(const QImage &image)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    const int size[2] = {image.width(), image.height()};
+    hash.addData(reinterpret_cast<const char *>(size), sizeof(size));
+    hash.addData(reinterpret_cast<const char *>(image.constBits()), image.byteCount());
+
+    return hash.result();
+}
+
 class PanelShadowsSingleton {
 public:
     PanelShadowsSingleton() {
@@ -162,6 +220,7 @@ void PanelShadows::removeWindow(const QWindow *window)
 
     if (d->m_windows.isEmpty()) {
         d->clearPixmaps();
+        d->freeX11Pixmaps();
     }
 }
 
@@ -171,6 +230,8 @@ void PanelShadows::setEnabledBorders(const QWindow *window, Plasma::FrameSvg::En
         return;
     }
 
+    //! only this window is updated
+    d->m_windows[window] = enabledBorders;
     d->updateShadow(window, enabledBorders);
 }
 
@@ -178,20 +239,28 @@ void PanelShadows::setEnabledBorders(const QWindow *window, Plasma::FrameSvg::En
 void PanelShadows::Private::windowDestroyed(QObject *deletedObject)
 {
     m_windows.remove(static_cast<QWindow *>(deletedObject));
+    m_writtenData.remove(static_cast<QWindow *>(deletedObject));
 
     if (m_windows.isEmpty()) {
         clearPixmaps();
+        freeX11Pixmaps();
     }
 }
 
 void PanelShadows::Private::updateShadows()
 {
-    setupPixmaps();
+    if (!setupPixmaps()) {
+        //! the same tiles and margins, the windows keep their shadows
+        return;
+    }
+
     QHash<const QWindow *, Plasma::FrameSvg::EnabledBorders>::const_iterator i;
 
     for (i = m_windows.constBegin(); i != m_windows.constEnd(); ++i) {
         updateShadow(i.key(), i.value());
     }
+
+    releaseUnusedX11Pixmaps();
 }
 
 Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap &source)
@@ -215,11 +284,17 @@ Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap &source)
     // check connection
     if (!_connection) _connection = QX11Info::connection();
 
-    const int width(source.width());
-    const int height(source.height());
+    const QImage image(source.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied));
+
+    //! identical tiles are uploaded only once
+    const QByteArray key = tileHash(image);
+
+    if (m_x11Pixmaps.contains(key)) {
+        return reinterpret_cast<Qt::HANDLE>(m_x11Pixmaps.value(key));
+    }
 
     // create X11 pixmap
-    Pixmap pixmap = XCreatePixmap(QX11Info::display(), QX11Info::appRootWindow(), width, height, 32);
+    Pixmap pixmap = XCreatePixmap(QX11Info::display(), QX11Info::appRootWindow(), image.width(), image.height(), 32);
 
     // check gc
     if (!_gc) {
@@ -227,24 +302,19 @@ Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap &source)
         xcb_create_gc(_connection, _gc, pixmap, 0, 0x0);
     }
 
-//         // create explicitly shared QPixmap from it
-//         QPixmap dest( QPixmap::fromX11Pixmap( pixmap, QPixmap::ExplicitlyShared ) );
-//
-//         // create surface for pixmap
-//         {
-//             QPainter painter( &dest );
-//             painter.setCompositionMode( QPainter::CompositionMode_Source );
-//             painter.drawPixmap( 0, 0, source );
-//         }
-//
-//
-//         return pixmap;
-    QImage image(source.toImage());
-    xcb_put_image(
-        _connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, _gc,
-        image.width(), image.height(), 0, 0,
-        0, 32,
-        image.byteCount(), image.constBits());
+#if HAVE_XCB_SHM
+
+    if (!uploadShm(pixmap, image))
+#endif
+    {
+        xcb_put_image(
+            _connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, _gc,
+            image.width(), image.height(), 0, 0,
+            0, 32,
+            image.byteCount(), image.constBits());
+    }
+
+    m_x11Pixmaps[key] = pixmap;
 
     return (Qt::HANDLE)pixmap;
 
@@ -254,6 +324,106 @@ Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap &source)
 
 }
 
+#if HAVE_XCB_SHM
+//! uploads the image through MIT-SHM, it returns false when the extension
+//! can not be used e.g. for remote X servers, then xcb_put_image is used
+bool PanelShadows::Private::uploadShm(unsigned long pixmap, const QImage &image)
+{
+    if (!m_shm.checked) {
+        m_shm.checked = true;
+        const xcb_query_extension_reply_t *extension = xcb_get_extension_data(_connection, &xcb_shm_id);
+        m_shm.available = extension && extension->present;
+    }
+
+    if (!m_shm.available) {
+        return false;
+    }
+
+    const int bytes = image.byteCount();
+
+    if (m_shm.used + bytes > m_shm.size) {
+        syncShm();
+    }
+
+    if (bytes > m_shm.size) {
+        freeShmSegment();
+
+        //! room for all the tiles of a shadow
+        const int size = qMax(8 * bytes, 256 * 1024);
+        m_shm.id = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+
+        if (m_shm.id < 0) {
+            m_shm.available = false;
+            return false;
+        }
+
+        void *address = shmat(m_shm.id, nullptr, 0);
+        //! the segment is destroyed when both sides have detached it
+        shmctl(m_shm.id, IPC_RMID, nullptr);
+
+        if (address == reinterpret_cast<void *>(-1)) {
+            m_shm.id = -1;
+            m_shm.available = false;
+            return false;
+        }
+
+        m_shm.address = static_cast<uchar *>(address);
+        m_shm.segment = xcb_generate_id(_connection);
+        xcb_generic_error_t *error = xcb_request_check(_connection, xcb_shm_attach_checked(_connection, m_shm.segment, m_shm.id, 0));
+
+        if (error) {
+            qDebug() << "MIT-SHM can not be used for the panel shadows, error code:" << error->error_code;
+            free(error);
+            shmdt(m_shm.address);
+            m_shm = Shm();
+            m_shm.checked = true;
+            return false;
+        }
+
+        m_shm.size = size;
+    }
+
+    memcpy(m_shm.address + m_shm.used, image.constBits(), bytes);
+    xcb_shm_put_image(_connection, pixmap, _gc,
+                      image.width(), image.height(), 0, 0,
+                      image.width(), image.height(), 0, 0,
+                      32, XCB_IMAGE_FORMAT_Z_PIXMAP, 0, m_shm.segment, m_shm.used);
+    m_shm.used += bytes;
+
+    return true;
+}
+
+//! the server must have read the written tiles before the segment is written again
+void PanelShadows::Private::syncShm()
+{
+    if (m_shm.used == 0 || !_connection) {
+        return;
+    }
+
+    free(xcb_get_input_focus_reply(_connection, xcb_get_input_focus(_connection), nullptr));
+    m_shm.used = 0;
+}
+
+void PanelShadows::Private::freeShmSegment()
+{
+    if (!m_shm.address) {
+        return;
+    }
+
+    if (_connection) {
+        xcb_shm_detach(_connection, m_shm.segment);
+        xcb_flush(_connection);
+    }
+
+    shmdt(m_shm.address);
+    m_shm.address = nullptr;
+    m_shm.id = -1;
+    m_shm.segment = 0;
+    m_shm.size = 0;
+    m_shm.used = 0;
+}
+#endif
+
 void PanelShadows::Private::initPixmap(const QString &element)
 {
     m_shadowPixmaps << q->pixmap(element);
@@ -280,9 +450,9 @@ QPixmap PanelShadows::Private::initEmptyPixmap(const QSize &size)
 #endif
 }
 
-void PanelShadows::Private::setupPixmaps()
+bool PanelShadows::Private::setupPixmaps()
 {
-    clearPixmaps();
+    m_shadowPixmaps.clear();
     initPixmap(QStringLiteral("shadow-top"));
     initPixmap(QStringLiteral("shadow-topright"));
     initPixmap(QStringLiteral("shadow-right"));
@@ -292,6 +462,35 @@ void PanelShadows::Private::setupPixmaps()
     initPixmap(QStringLiteral("shadow-left"));
     initPixmap(QStringLiteral("shadow-topleft"));
 
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    QList<QImage> images;
+    QList<QByteArray> hashes;
+
+    foreach (const QPixmap &pixmap, m_shadowPixmaps) {
+        images << pixmap.toImage();
+        hashes << tileHash(images.last());
+        hash.addData(hashes.last());
+    }
+
+    const QStringList hints{QStringLiteral("shadow-hint-top-margin"), QStringLiteral("shadow-hint-right-margin")
+                            , QStringLiteral("shadow-hint-bottom-margin"), QStringLiteral("shadow-hint-left-margin")};
+
+    foreach (const QString &hint, hints) {
+        const QSize size = q->elementSize(hint);
+        const int values[2] = {size.width(), size.height()};
+        hash.addData(reinterpret_cast<const char *>(values), sizeof(values));
+    }
+
+    const QByteArray tilesHash = hash.result();
+
+    if (tilesHash == m_tilesHash) {
+        return false;
+    }
+
+    m_tilesHash = tilesHash;
+    //! the X pixmaps of unchanged tiles are found again by their hash
+    data.clear();
+
     m_emptyCornerPix = initEmptyPixmap(QSize(1, 1));
     m_emptyCornerLeftPix = initEmptyPixmap(QSize(q->elementSize(QStringLiteral("shadow-topleft")).width(), 1));
     m_emptyCornerTopPix = initEmptyPixmap(QSize(1, q->elementSize(QStringLiteral("shadow-topleft")).height()));
@@ -301,10 +500,32 @@ void PanelShadows::Private::setupPixmaps()
     m_emptyHorizontalPix = initEmptyPixmap(QSize(q->elementSize(QStringLiteral("shadow-top")).width(), 1));
 
     if (m_wayland.shmPool) {
-        for (auto it = m_shadowPixmaps.constBegin(); it != m_shadowPixmaps.constEnd(); ++it) {
-            m_wayland.shadowBuffers << m_wayland.shmPool->createBuffer(it->toImage());
+        //! the buffers of unchanged tiles are kept, the rest go back to the
+        //! pool, which reuses them for the new tiles of the same size
+        QList<KWayland::Client::Buffer::Ptr> buffers;
+
+        for (int i = 0; i < m_shadowPixmaps.size(); ++i) {
+            if (i < m_wayland.tileHashes.size() && m_wayland.tileHashes[i] == hashes[i]) {
+                buffers << m_wayland.shadowBuffers.at(i);
+                continue;
+            }
+
+            if (i < m_wayland.shadowBuffers.size()) {
+                m_wayland.bufferPool->release(m_wayland.shadowBuffers.at(i));
+            }
+
+            const QPixmap &tile = m_shadowPixmaps[i];
+            buffers << m_wayland.bufferPool->acquire(tile.size(), [&tile](QPainter * painter) {
+                painter->setCompositionMode(QPainter::CompositionMode_Source);
+                painter->drawPixmap(0, 0, tile);
+            });
         }
+
+        m_wayland.shadowBuffers = buffers;
+        m_wayland.tileHashes = hashes;
     }
+
+    return true;
 }
 
 
@@ -392,6 +613,9 @@ void PanelShadows::Private::setupData(Plasma::FrameSvg::EnabledBorders enabledBo
         data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
     }
 
+#if HAVE_XCB_SHM
+    syncShm();
+#endif
 #endif
 
     int left, top, right, bottom = 0;
@@ -463,38 +687,43 @@ void PanelShadows::Private::freeX11Pixmaps()
         return;
     }
 
-    foreach (const QPixmap &pixmap, m_shadowPixmaps) {
-        if (!pixmap.isNull()) {
-            XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(pixmap)));
-        }
+    foreach (unsigned long pixmap, m_x11Pixmaps) {
+        XFreePixmap(display, pixmap);
     }
 
-    if (!m_emptyCornerPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix)));
-    }
+    m_x11Pixmaps.clear();
 
-    if (!m_emptyCornerBottomPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerBottomPix)));
-    }
+#if HAVE_XCB_SHM
+    freeShmSegment();
+#endif
+#endif
+}
 
-    if (!m_emptyCornerLeftPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerLeftPix)));
-    }
+//! frees the X pixmaps that are not used by any window after a theme reload
+void PanelShadows::Private::releaseUnusedX11Pixmaps()
+{
+#if HAVE_X11
 
-    if (!m_emptyCornerRightPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerRightPix)));
+    if (!m_isX11 || !QX11Info::display()) {
+        return;
     }
 
-    if (!m_emptyCornerTopPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerTopPix)));
-    }
+    QSet<unsigned long> used;
 
-    if (!m_emptyVerticalPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyVerticalPix)));
+    foreach (const auto &windowData, data) {
+        //! the first eight values are the tiles, the rest are the margins
+        for (int i = 0; i < 8 && i < windowData.size(); ++i) {
+            used << windowData[i];
+        }
     }
 
-    if (!m_emptyHorizontalPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyHorizontalPix)));
+    for (auto it = m_x11Pixmaps.begin(); it != m_x11Pixmaps.end();) {
+        if (!used.contains(it.value())) {
+            XFreePixmap(QX11Info::display(), it.value());
+            it = m_x11Pixmaps.erase(it);
+        } else {
+            ++it;
+        }
     }
 
 #endif
@@ -503,8 +732,7 @@ void PanelShadows::Private::freeX11Pixmaps()
 void PanelShadows::Private::clearPixmaps()
 {
 #if HAVE_X11
-    freeX11Pixmaps();
-
+    //! the X pixmaps are kept, the new tiles can reuse them
     m_emptyCornerPix = QPixmap();
     m_emptyCornerBottomPix = QPixmap();
     m_emptyCornerLeftPix = QPixmap();
@@ -516,11 +744,18 @@ void PanelShadows::Private::clearPixmaps()
     freeWaylandBuffers();
     m_shadowPixmaps.clear();
     data.clear();
+    m_tilesHash.clear();
+    m_writtenData.clear();
 }
 
 void PanelShadows::Private::freeWaylandBuffers()
 {
+    if (m_wayland.bufferPool) {
+        m_wayland.bufferPool->releaseAll();
+    }
+
     m_wayland.shadowBuffers.clear();
+    m_wayland.tileHashes.clear();
 }
 
 void PanelShadows::Private::updateShadow(const QWindow *window, Plasma::FrameSvg::EnabledBorders enabledBorders)
@@ -550,6 +785,15 @@ void PanelShadows::Private::updateShadowX11(const QWindow *window, Plasma::Frame
         setupData(enabledBorders);
     }
 
+    //! skip the property write when the window has already that shadow
+    const auto written = m_writtenData.value(window);
+
+    if (written.first == window->winId() && written.second == data[enabledBorders]) {
+        return;
+    }
+
+    m_writtenData[window] = qMakePair(window->winId(), data[enabledBorders]);
+
     Display *dpy = QX11Info::display();
     Atom atom = XInternAtom(dpy, "_KDE_NET_WM_SHADOW", False);
 
@@ -693,6 +937,8 @@ void PanelShadows::Private::clearShadow(const QWindow *window)
 void PanelShadows::Private::clearShadowX11(const QWindow *window)
 {
 #if HAVE_X11
+    m_writtenData.remove(window);
+
     Display *dpy = QX11Info::display();
     Atom atom = XInternAtom(dpy, "_KDE_NET_WM_SHADOW", False);
     XDeleteProperty(dpy, window->winId(), atom);
@@ -734,12 +980,16 @@ void PanelShadows::Private::setupWaylandIntegration()
     connect(registry, &Registry::shadowAnnounced, q,
     [this, registry](quint32 name, quint32 version) {
         m_wayland.manager = registry->createShadowManager(name, version, q);
+        //! the windows have no shadows yet even if the tiles are rendered
+        m_tilesHash.clear();
         updateShadows();
     }, Qt::QueuedConnection
            );
     connect(registry, &Registry::shmAnnounced, q,
     [this, registry](quint32 name, quint32 version) {
         m_wayland.shmPool = registry->createShmPool(name, version, q);
+        m_wayland.bufferPool = std::make_unique<Latte::ShmBufferPool>(m_wayland.shmPool);
+        m_tilesHash.clear();
         updateShadows();
     }, Qt::QueuedConnection
            );
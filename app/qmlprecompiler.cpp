@@ -0,0 +1,123 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "qmlprecompiler.h"
+
+#include <QDebug>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QUrl>
+
+namespace Latte {
+
+//! one file is compiled in every idle slot
+constexpr int CompileInterval = 50;
+
+QmlPrecompiler::QmlPrecompiler(QQmlEngine *engine, QObject *parent)
+    : QObject(parent),
+      m_engine(engine)
+{
+    m_nextTimer.setSingleShot(true);
+    m_nextTimer.setInterval(CompileInterval);
+    connect(&m_nextTimer, &QTimer::timeout, this, &QmlPrecompiler::compileNext);
+}
+
+QmlPrecompiler::~QmlPrecompiler()
+{
+}
+
+void QmlPrecompiler::start(const QStringList &packages)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 8, 0)
+    Q_UNUSED(packages);
+    qDebug() << "qml precompiler: the disk cache needs Qt 5.8";
+    emit finished();
+#else
+
+    if (!qEnvironmentVariableIsEmpty("QML_DISABLE_DISK_CACHE")) {
+        qDebug() << "qml precompiler: the disk cache is disabled";
+        emit finished();
+        return;
+    }
+
+    m_files.clear();
+    m_precompiled = 0;
+    m_compiled = 0;
+
+    for (const auto &package : packages) {
+        QDirIterator it(package, {QStringLiteral("*.qml")}, QDir::Files, QDirIterator::Subdirectories);
+
+        while (it.hasNext()) {
+            const QString file = it.next();
+
+            //! the units of the build are loaded by the engine directly
+            if (QFileInfo::exists(file + QLatin1Char('c'))) {
+                ++m_precompiled;
+            } else {
+                m_files << file;
+            }
+        }
+    }
+
+    qDebug() << "qml precompiler: precompiled:" << m_precompiled << "to compile:" << m_files.count();
+
+    m_timer.start();
+    m_nextTimer.start();
+#endif
+}
+
+void QmlPrecompiler::compileNext()
+{
+    if (m_files.isEmpty() || !m_engine) {
+        qDebug() << "qml precompiler: compiled" << m_compiled << "files in" << m_timer.elapsed() << "ms";
+        emit finished();
+        return;
+    }
+
+    //! compiling does not create the objects, the files that are already
+    //! loaded are found in the type cache of the engine
+    m_component = new QQmlComponent(m_engine, QUrl::fromLocalFile(m_files.takeFirst()), QQmlComponent::Asynchronous, this);
+
+    if (m_component->isLoading()) {
+        connect(m_component, &QQmlComponent::statusChanged, this, &QmlPrecompiler::componentStatusChanged);
+    } else {
+        componentStatusChanged();
+    }
+}
+
+void QmlPrecompiler::componentStatusChanged()
+{
+    if (!m_component || m_component->isLoading()) {
+        return;
+    }
+
+    if (m_component->isError()) {
+        qDebug() << "qml precompiler:" << m_component->url() << m_component->errorString();
+    } else {
+        ++m_compiled;
+    }
+
+    m_component->deleteLater();
+    m_nextTimer.start();
+}
+
+}
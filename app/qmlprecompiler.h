@@ -0,0 +1,74 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QMLPRECOMPILER_H
+#define QMLPRECOMPILER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+
+class QQmlComponent;
+class QQmlEngine;
+
+namespace Latte {
+
+/**
+ * @brief The QmlPrecompiler class, compiles in idle time the QML files of
+ * the packages that have no precompiled unit installed next to them, e.g.
+ * the configuration windows that are not loaded at startup.
+ *
+ * The engine stores the compiled units in its disk cache, so the next time
+ * these files are loaded they are not parsed or compiled again.
+ */
+class QmlPrecompiler : public QObject {
+    Q_OBJECT
+
+public:
+    QmlPrecompiler(QQmlEngine *engine, QObject *parent = nullptr);
+    ~QmlPrecompiler() override;
+
+    //! the package directories whose contents are compiled
+    void start(const QStringList &packages);
+
+signals:
+    void finished();
+
+private:
+    void compileNext();
+    void componentStatusChanged();
+
+    int m_precompiled{0};
+    int m_compiled{0};
+
+    QStringList m_files;
+
+    QElapsedTimer m_timer;
+    QTimer m_nextTimer;
+
+    QPointer<QQmlComponent> m_component;
+    QPointer<QQmlEngine> m_engine;
+};
+
+}
+
+#endif // QMLPRECOMPILER_H
@@ -18,6 +18,7 @@
  */
 
 #include "screenpool.h"
+#include "../liblattedock/startuptrace.h"
 #include <config-latte.h>
 
 #include <QDebug>
@@ -35,16 +36,77 @@ ScreenPool::ScreenPool(KSharedConfig::Ptr config, QObject *parent)
     : QObject(parent),
       m_configGroup(KConfigGroup(config, QStringLiteral("ScreenConnectors")))
 {
-    qApp->installNativeEventFilter(this);
-
     m_configSaveTimer.setSingleShot(true);
     connect(&m_configSaveTimer, &QTimer::timeout, this, [this]() {
         m_configGroup.sync();
     });
+
+    m_topologyTimer.setSingleShot(true);
+    m_topologyTimer.setInterval(250);
+    connect(&m_topologyTimer, &QTimer::timeout, this, &ScreenPool::updateTopology);
+
+    //! the RandR events are the only notification for some changes on X11,
+    //! the Qt signals are enough for the other platforms
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, [this](QScreen * screen) {
+        watchScreen(screen);
+        updateScreens();
+    });
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, [this](QScreen * screen) {
+        updateScreens(screen);
+    });
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, [this]() {
+        updateScreens();
+    });
+
+    for (QScreen *screen : qGuiApp->screens()) {
+        watchScreen(screen);
+    }
+
+    updateScreens();
+
+    connect(qGuiApp, &QGuiApplication::screenAdded, &m_topologyTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(qGuiApp, &QGuiApplication::screenRemoved, &m_topologyTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, &m_topologyTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+
+#if HAVE_X11
+
+    if (QX11Info::isPlatformX11()) {
+        xcb_connection_t *c = QX11Info::connection();
+        const xcb_query_extension_reply_t *reply = xcb_get_extension_data(c, &xcb_randr_id);
+
+        if (reply && reply->present) {
+            m_randrFirstEvent = reply->first_event;
+
+            //! the selection is per client, Qt has already selected these
+            //! for the root window so its own mask must be kept intact
+            xcb_randr_select_input(c, QX11Info::appRootWindow(),
+                                   XCB_RANDR_NOTIFY_MASK_SCREEN_CHANGE
+                                   | XCB_RANDR_NOTIFY_MASK_OUTPUT_CHANGE
+                                   | XCB_RANDR_NOTIFY_MASK_CRTC_CHANGE
+                                   | XCB_RANDR_NOTIFY_MASK_OUTPUT_PROPERTY);
+
+            qApp->installNativeEventFilter(this);
+        } else {
+            qWarning() << "RandR extension is not available, screen changes are tracked only through Qt";
+        }
+    }
+
+#endif
+}
+
+void ScreenPool::watchScreen(QScreen *screen)
+{
+    connect(screen, &QScreen::geometryChanged, this, [this, screen]() {
+        emit screenGeometryChanged(screen);
+        //! moved or resized outputs are topology changes too
+        m_topologyTimer.start();
+    });
 }
 
 void ScreenPool::load()
 {
+    LATTE_TRACE_SCOPE("ScreenPool::load");
+
     m_primaryConnector = QString();
     m_connectorForId.clear();
     m_idForConnector.clear();
@@ -86,10 +148,23 @@ void ScreenPool::load()
             insertScreenMapping(firstAvailableId(), screen->name());
         }
     }
+
+    //the topology that the next changes are compared against
+    m_outputs.clear();
+
+    for (QScreen *screen : qGuiApp->screens()) {
+        m_outputs[screen->name()] = screen->geometry();
+    }
+
+    m_outputsPrimary = m_primaryConnector;
 }
 
 ScreenPool::~ScreenPool()
 {
+    if (m_randrFirstEvent >= 0) {
+        qApp->removeNativeEventFilter(this);
+    }
+
     m_configGroup.sync();
 }
 
@@ -198,39 +273,134 @@ QList <int> ScreenPool::knownIds() const
     return m_connectorForId.keys();
 }
 
-bool ScreenPool::nativeEventFilter(const QByteArray &eventType, void *message, long int *result)
+bool ScreenPool::isKnownId(int id) const
 {
-    Q_UNUSED(result);
-#if HAVE_X11
+    return m_connectorForId.contains(id);
+}
+
+void ScreenPool::updateScreens(QScreen *removed)
+{
+    QHash<QString, QScreen *> screens;
+
+    for (QScreen *screen : qGuiApp->screens()) {
+        //! depending on the Qt version the removed screen can still be listed
+        if (screen != removed) {
+            screens[screen->name()] = screen;
+        }
+    }
+
+    if (screens != m_screenForConnector) {
+        m_screenForConnector = screens;
+        emit screensChanged();
+    }
+}
+
+QScreen *ScreenPool::screen(const QString &connector) const
+{
+    QScreen *scr = m_screenForConnector.value(connector);
+
+    //! a QScreen can be recycled for a different output without any signal,
+    //! see the edge case in updateTopology, the registry is refreshed there
+    return (scr && scr->name() == connector) ? scr : nullptr;
+}
+
+QScreen *ScreenPool::screen(int id) const
+{
+    if (!m_connectorForId.contains(id)) {
+        return nullptr;
+    }
+
+    return screen(m_connectorForId.value(id));
+}
+
+bool ScreenPool::hasScreen(const QString &connector) const
+{
+    return screen(connector) != nullptr;
+}
+
+void ScreenPool::updateTopology()
+{
+    updateScreens();
+
+    QHash<QString, QRect> outputs;
+
+    for (QScreen *screen : qGuiApp->screens()) {
+        outputs[screen->name()] = screen->geometry();
+    }
+
+    const QString primary = qGuiApp->primaryScreen() ? qGuiApp->primaryScreen()->name() : QString();
+
+    ScreenTopologyDelta delta;
+
+    for (auto it = outputs.constBegin(); it != outputs.constEnd(); ++it) {
+        if (!m_outputs.contains(it.key())) {
+            delta.added << it.key();
+        } else if (m_outputs.value(it.key()) != it.value()) {
+            delta.moved << it.key();
+        }
+    }
+
+    for (auto it = m_outputs.constBegin(); it != m_outputs.constEnd(); ++it) {
+        if (!outputs.contains(it.key())) {
+            delta.removed << it.key();
+        }
+    }
+
+    delta.primaryChanged = (primary != m_outputsPrimary);
+    delta.primary = primary;
+
+    m_outputs = outputs;
+    m_outputsPrimary = primary;
+
+    foreach (const QString &connector, delta.added) {
+        if (id(connector) < 0) {
+            insertScreenMapping(firstAvailableId(), connector);
+        }
+    }
 
     // a particular edge case: when we switch the only enabled screen
     // we don't have any signal about it, the primary screen changes but we have the same old QScreen* getting recycled
     // see https://bugs.kde.org/show_bug.cgi?id=373880
-    // if this slot will be invoked many times, their//second time on will do nothing as name and primaryconnector will be the same by then
-    if (eventType != "xcb_generic_event_t") {
-        return false;
-    }
+    if (!primary.isEmpty() && primary != primaryConnector()) {
+        //new screen?
+        if (id(primary) < 0) {
+            insertScreenMapping(firstAvailableId(), primary);
+        }
 
-    xcb_generic_event_t *ev = static_cast<xcb_generic_event_t *>(message);
+        //switch the primary screen in the pool
+        setPrimaryConnector(primary);
 
-    const auto responseType = XCB_EVENT_RESPONSE_TYPE(ev);
+        emit primaryPoolChanged();
+    }
 
-    const xcb_query_extension_reply_t *reply = xcb_get_extension_data(QX11Info::connection(), &xcb_randr_id);
+    if (!delta.isEmpty()) {
+        qDebug() << "screen topology changed, added:" << delta.added << "removed:" << delta.removed
+                 << "moved:" << delta.moved << "primary:" << delta.primary;
+        emit topologyChanged(delta);
+    }
+}
 
-    if (responseType == reply->first_event + XCB_RANDR_SCREEN_CHANGE_NOTIFY) {
-        if (qGuiApp->primaryScreen()->name() != primaryConnector()) {
-            //new screen?
-            if (id(qGuiApp->primaryScreen()->name()) < 0) {
-                insertScreenMapping(firstAvailableId(), qGuiApp->primaryScreen()->name());
-            }
+bool ScreenPool::nativeEventFilter(const QByteArray &eventType, void *message, long int *result)
+{
+    Q_UNUSED(result);
+#if HAVE_X11
 
-            //switch the primary screen in the pool
-            setPrimaryConnector(qGuiApp->primaryScreen()->name());
+    //! it runs for every xcb event of the application, so it only
+    //! restarts the timer, the topology is read when the burst is over
+    if (m_randrFirstEvent < 0 || eventType != "xcb_generic_event_t") {
+        return false;
+    }
 
-            emit primaryPoolChanged();
-        }
+    const auto responseType = XCB_EVENT_RESPONSE_TYPE(static_cast<xcb_generic_event_t *>(message));
+
+    if (responseType == m_randrFirstEvent + XCB_RANDR_SCREEN_CHANGE_NOTIFY
+        || responseType == m_randrFirstEvent + XCB_RANDR_NOTIFY) {
+        m_topologyTimer.start();
     }
 
+#else
+    Q_UNUSED(eventType);
+    Q_UNUSED(message);
 #endif
     return false;
 }
@@ -22,13 +22,31 @@
 
 #include <QObject>
 #include <QHash>
+#include <QRect>
 #include <QString>
+#include <QStringList>
 #include <QTimer>
 #include <QAbstractNativeEventFilter>
 
 #include <KConfigGroup>
 #include <KSharedConfig>
 
+class QScreen;
+
+//! the difference between two screen topologies, by connector names
+struct ScreenTopologyDelta {
+    QStringList added;
+    QStringList removed;
+    //! outputs that are still present but their geometry changed
+    QStringList moved;
+    bool primaryChanged{false};
+    QString primary;
+
+    bool isEmpty() const {
+        return added.isEmpty() && removed.isEmpty() && moved.isEmpty() && !primaryChanged;
+    }
+};
+
 class ScreenPool : public QObject, public QAbstractNativeEventFilter {
     Q_OBJECT
 
@@ -50,23 +68,49 @@ public:
 
     //all ids that are known, included screens not enabled at the moment
     QList <int> knownIds() const;
+    bool isKnownId(int id) const;
+
+    //! the live registry of the running screens, nullptr when the screen
+    //! is not running at the moment
+    QScreen *screen(const QString &connector) const;
+    QScreen *screen(int id) const;
+    bool hasScreen(const QString &connector) const;
 
 signals:
     void primaryPoolChanged();
+    //! the running screens changed, emitted immediately
+    void screensChanged();
+    void screenGeometryChanged(QScreen *screen);
+    //! emitted once for each burst of output changes
+    void topologyChanged(const ScreenTopologyDelta &delta);
 
 protected:
     bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) Q_DECL_OVERRIDE;
 
 private:
     void save();
+    void updateScreens(QScreen *removed = nullptr);
+    void watchScreen(QScreen *screen);
+    void updateTopology();
 
     KConfigGroup m_configGroup;
     QString m_primaryConnector;
     //order is important
     QMap<int, QString> m_connectorForId;
     QHash<QString, int> m_idForConnector;
+    //! connector -> running screen
+    QHash<QString, QScreen *> m_screenForConnector;
 
     QTimer m_configSaveTimer;
+
+    //! the RandR events arrive in bursts e.g. when a docking station is
+    //! plugged, they are handled together after the burst is over
+    QTimer m_topologyTimer;
+    //! connector -> geometry, as it was when topologyChanged was last emitted
+    QHash<QString, QRect> m_outputs;
+    QString m_outputsPrimary;
+    //! -1 when the RandR events are not tracked
+    int m_randrFirstEvent{ -1};
 };
 
 #endif // SCREENPOOL_H
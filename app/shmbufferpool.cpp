@@ -0,0 +1,102 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "shmbufferpool.h"
+
+#include <QDebug>
+#include <QImage>
+#include <QPainter>
+
+#include <KWayland/Client/shm_pool.h>
+
+namespace Latte {
+
+ShmBufferPool::ShmBufferPool(KWayland::Client::ShmPool *pool)
+    : m_pool(pool)
+{
+}
+
+ShmBufferPool::~ShmBufferPool()
+{
+    releaseAll();
+}
+
+KWayland::Client::Buffer::Ptr ShmBufferPool::acquire(const QSize &size, const std::function<void(QPainter *)> &paint)
+{
+    using KWayland::Client::Buffer;
+
+    if (!m_pool || !m_pool->isValid() || size.isEmpty()) {
+        return Buffer::Ptr();
+    }
+
+    const int stride = size.width() * 4;
+    Buffer::Ptr buffer = m_pool->getBuffer(size, stride, Buffer::Format::ARGB32);
+    auto strongBuffer = buffer.toStrongRef();
+
+    if (!strongBuffer) {
+        qWarning() << "shm pool could not provide a buffer of size" << size;
+        return Buffer::Ptr();
+    }
+
+    //! not handed out again by the ShmPool until it is released
+    strongBuffer->setUsed(true);
+
+    //! wraps the shm mapping, no pixels are copied through a QImage
+    QImage target(strongBuffer->address(), size.width(), size.height(), stride, QImage::Format_ARGB32_Premultiplied);
+    target.fill(Qt::transparent);
+
+    if (paint) {
+        QPainter painter(&target);
+        paint(&painter);
+    }
+
+    m_used << buffer;
+
+    return buffer;
+}
+
+void ShmBufferPool::release(const KWayland::Client::Buffer::Ptr &buffer)
+{
+    if (!m_used.removeOne(buffer)) {
+        return;
+    }
+
+    if (auto strongBuffer = buffer.toStrongRef()) {
+        strongBuffer->setUsed(false);
+    }
+}
+
+void ShmBufferPool::releaseAll()
+{
+    foreach (const auto &buffer, m_used) {
+        if (auto strongBuffer = buffer.toStrongRef()) {
+            strongBuffer->setUsed(false);
+        }
+    }
+
+    m_used.clear();
+}
+
+int ShmBufferPool::usedBuffers() const
+{
+    return m_used.size();
+}
+
+}
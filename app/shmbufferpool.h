@@ -0,0 +1,77 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHMBUFFERPOOL_H
+#define SHMBUFFERPOOL_H
+
+#include <functional>
+
+#include <QList>
+#include <QSize>
+
+#include <KWayland/Client/buffer.h>
+
+class QPainter;
+
+namespace KWayland {
+namespace Client {
+class ShmPool;
+}
+}
+
+namespace Latte {
+
+/**
+ * @brief The ShmBufferPool class, hands out ARGB32 buffers of a
+ * KWayland::Client::ShmPool and keeps them marked as used until they are
+ * released. Once the compositor has released them too, they are reused
+ * by the ShmPool for the next request of the same size, so a theme reload
+ * does not grow the pool.
+ *
+ * The pixels are painted directly in the shm mapping of the buffer.
+ * It depends only on the ShmPool, so it can work against any compositor
+ * that announces wl_shm, including a headless one, see
+ * autotests/shmbufferpooltest.cpp.
+ */
+class ShmBufferPool final {
+public:
+    explicit ShmBufferPool(KWayland::Client::ShmPool *pool);
+    ~ShmBufferPool();
+
+    /*!
+     * @brief a buffer of that size, paint receives a painter on the shm
+     * mapping which has been cleared to transparent. Returns a null
+     * pointer when the pool can not provide a buffer
+     */
+    KWayland::Client::Buffer::Ptr acquire(const QSize &size, const std::function<void(QPainter *)> &paint);
+
+    void release(const KWayland::Client::Buffer::Ptr &buffer);
+    void releaseAll();
+
+    int usedBuffers() const;
+
+private:
+    KWayland::Client::ShmPool *m_pool{nullptr};
+    QList<KWayland::Client::Buffer::Ptr> m_used;
+};
+
+}
+
+#endif // SHMBUFFERPOOL_H
@@ -0,0 +1,157 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "startuptracer.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace Latte {
+
+StartupTracer::StartupTracer(const QString &fileName, const QElapsedTimer &timer)
+    : m_fileName(fileName),
+      m_timer(timer)
+{
+    m_events.reserve(1024);
+}
+
+StartupTracer::~StartupTracer()
+{
+    write();
+}
+
+void StartupTracer::install()
+{
+    qApp->setProperty(StartupTrace::RecorderProperty, QVariant::fromValue(reinterpret_cast<quintptr>(static_cast<StartupTrace::Recorder *>(this))));
+}
+
+qint64 StartupTracer::now() const
+{
+    return m_timer.nsecsElapsed() / 1000;
+}
+
+void StartupTracer::complete(const char *name, const char *category, qint64 begin, qint64 end, const QString &detail)
+{
+    append({name, category, 'X', begin, end - begin, 0, detail});
+}
+
+void StartupTracer::instant(const char *name, const char *category, const QString &detail)
+{
+    append({name, category, 'i', now(), 0, 0, detail});
+}
+
+void StartupTracer::append(Event &&event)
+{
+    const QThread *thread = QThread::currentThread();
+    event.thread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_written) {
+        return;
+    }
+
+    if (!m_threads.contains(event.thread)) {
+        QString name = thread->objectName();
+
+        if (name.isEmpty()) {
+            name = thread == qApp->thread() ? QStringLiteral("GUI") : QStringLiteral("Thread %1").arg(m_threads.count());
+        }
+
+        m_threads[event.thread] = name;
+    }
+
+    m_events.append(std::move(event));
+}
+
+bool StartupTracer::write()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_written) {
+        return true;
+    }
+
+    m_written = true;
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray events;
+
+    for (auto it = m_threads.constBegin(); it != m_threads.constEnd(); ++it) {
+        events.append(QJsonObject{
+            {QStringLiteral("name"), QStringLiteral("thread_name")},
+            {QStringLiteral("ph"), QStringLiteral("M")},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), static_cast<qint64>(it.key())},
+            {QStringLiteral("args"), QJsonObject{{QStringLiteral("name"), it.value()}}}
+        });
+    }
+
+    for (const auto &event : m_events) {
+        QJsonObject object{
+            {QStringLiteral("name"), QString::fromLatin1(event.name)},
+            {QStringLiteral("cat"), QString::fromLatin1(event.category)},
+            {QStringLiteral("ph"), QString(QLatin1Char(event.phase))},
+            {QStringLiteral("ts"), event.begin},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), static_cast<qint64>(event.thread)}
+        };
+
+        if (event.phase == 'X') {
+            object[QStringLiteral("dur")] = event.duration;
+        } else {
+            //! the instant events are drawn across their thread
+            object[QStringLiteral("s")] = QStringLiteral("t");
+        }
+
+        if (!event.detail.isEmpty()) {
+            object[QStringLiteral("args")] = QJsonObject{{QStringLiteral("detail"), event.detail}};
+        }
+
+        events.append(object);
+    }
+
+    QFile file(m_fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "the startup trace can not be written to" << m_fileName;
+        return false;
+    }
+
+    const QJsonObject trace{
+        {QStringLiteral("traceEvents"), events},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")}
+    };
+
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    qInfo() << "startup trace with" << m_events.count() << "events written to" << m_fileName;
+
+    m_events.clear();
+
+    return true;
+}
+
+}
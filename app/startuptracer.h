@@ -0,0 +1,80 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+
+#include "../liblattedock/startuptrace.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+namespace Latte {
+
+/**
+ * @brief The StartupTracer class, records the startup spans of latte-dock
+ * and of the lattedock plugin and writes them as Chrome trace event JSON,
+ * it can be opened in chrome://tracing or Perfetto.
+ */
+class StartupTracer final : public StartupTrace::Recorder {
+public:
+    //! the timer must have been started at the beginning of main()
+    StartupTracer(const QString &fileName, const QElapsedTimer &timer);
+    ~StartupTracer() override;
+
+    //! publishes the tracer, the spans are recorded from then on
+    void install();
+
+    qint64 now() const override;
+    void complete(const char *name, const char *category, qint64 begin, qint64 end, const QString &detail) override;
+    void instant(const char *name, const char *category, const QString &detail) override;
+
+    //! writes the file once, the later events are ignored
+    bool write();
+
+private:
+    struct Event {
+        const char *name;
+        const char *category;
+        char phase;
+        qint64 begin;
+        qint64 duration;
+        quint64 thread;
+        QString detail;
+    };
+
+    void append(Event &&event);
+
+    bool m_written{false};
+
+    QString m_fileName;
+    QElapsedTimer m_timer;
+
+    mutable QMutex m_mutex;
+    QVector<Event> m_events;
+    //! thread id -> name, the first thread is the GUI one
+    QHash<quint64, QString> m_threads;
+};
+
+}
+
+#endif // STARTUPTRACER_H
@@ -0,0 +1,131 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "taskmanagerregistry.h"
+#include "../liblattedock/taskmanagerinterface.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QQuickItem>
+#include <QQuickWindow>
+
+namespace Latte {
+
+TaskManagerRegistry::TaskManagerRegistry(QObject *parent)
+    : QObject(parent)
+{
+    qApp->setProperty(TaskManagerRegistryProperty, QVariant::fromValue<QObject *>(this));
+}
+
+TaskManagerRegistry::~TaskManagerRegistry()
+{
+    qApp->setProperty(TaskManagerRegistryProperty, QVariant());
+}
+
+void TaskManagerRegistry::registerEndpoint(QObject *endpoint)
+{
+    auto *interface = qobject_cast<TaskManagerInterface *>(endpoint);
+
+    if (!interface) {
+        qWarning() << "task manager endpoint does not implement the interface:" << endpoint;
+        return;
+    }
+
+    foreach (const Endpoint &registered, m_endpoints) {
+        if (registered.object == endpoint) {
+            return;
+        }
+    }
+
+    m_endpoints << Endpoint{endpoint, interface};
+    qDebug() << "task manager endpoint registered, endpoints:" << m_endpoints.count();
+}
+
+void TaskManagerRegistry::unregisterEndpoint(QObject *endpoint)
+{
+    for (int i = m_endpoints.size() - 1; i >= 0; --i) {
+        //! the destroyed endpoints are removed too
+        if (!m_endpoints[i].object || m_endpoints[i].object == endpoint) {
+            m_endpoints.removeAt(i);
+        }
+    }
+}
+
+bool TaskManagerRegistry::activateTaskAtIndex(int index, bool newInstance, QScreen *preferred)
+{
+    auto activate = [index, newInstance](const Endpoint & endpoint) {
+        if (newInstance) {
+            endpoint.interface->newInstanceForTaskAtIndex(index);
+        } else {
+            endpoint.interface->activateTaskAtIndex(index);
+        }
+    };
+
+    int fallback{ -1};
+
+    // To avoid overly complex configuration, we'll try to get the 90% usecase to work
+    // which is activating a task on the task manager on a dock on the primary screen.
+    for (int i = 0; i < m_endpoints.size(); ++i) {
+        const Endpoint &endpoint = m_endpoints.at(i);
+
+        if (!endpoint.object) {
+            continue;
+        }
+
+        auto *item = qobject_cast<QQuickItem *>(endpoint.object);
+
+        //! e.g. the docks of the other session that are kept on standby
+        if (item && item->window() && !item->window()->isVisible()) {
+            continue;
+        }
+
+        if (item && item->window() && item->window()->screen() == preferred) {
+            activate(endpoint);
+            return true;
+        }
+
+        if (fallback == -1) {
+            fallback = i;
+        }
+    }
+
+    if (fallback >= 0) {
+        activate(m_endpoints.at(fallback));
+        return true;
+    }
+
+    return false;
+}
+
+void TaskManagerRegistry::updateItems(const QVariantList &updates)
+{
+    foreach (const Endpoint &endpoint, m_endpoints) {
+        if (endpoint.object) {
+            endpoint.interface->updateItems(updates);
+        }
+    }
+}
+
+int TaskManagerRegistry::count() const
+{
+    return m_endpoints.count();
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TASKMANAGERREGISTRY_H
+#define TASKMANAGERREGISTRY_H
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QVariantList>
+
+class QScreen;
+
+namespace Latte {
+
+class TaskManagerInterface;
+
+/**
+ * @brief The TaskManagerRegistry class, the Latte task managers register
+ * their endpoint here when they are loaded. The global shortcuts and the
+ * badge updates are dispatched directly to them, instead of searching
+ * the applets and their QML items for the methods.
+ */
+class TaskManagerRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TaskManagerRegistry(QObject *parent = nullptr);
+    ~TaskManagerRegistry() override;
+
+    /*!
+     * @brief activates the task at index, the task managers shown at the
+     * preferred screen are tried first and hidden ones are skipped. Returns
+     * false if no shown task manager is registered
+     */
+    bool activateTaskAtIndex(int index, bool newInstance, QScreen *preferred);
+    void updateItems(const QVariantList &updates);
+
+    int count() const;
+
+public slots:
+    //! called by the endpoints through the meta object, they live in the plugin
+    void registerEndpoint(QObject *endpoint);
+    void unregisterEndpoint(QObject *endpoint);
+
+private:
+    struct Endpoint {
+        QPointer<QObject> object;
+        TaskManagerInterface *interface;
+    };
+
+    QList<Endpoint> m_endpoints;
+};
+
+}
+
+#endif // TASKMANAGERREGISTRY_H
@@ -483,6 +483,25 @@ inline void VisibilityManagerPrivate::restoreConfig()
     });
 }
 
+void VisibilityManagerPrivate::applyHandoffState(bool wasHidden, const QRect &geometry)
+{
+    //! AlwaysVisible is applied without a delay
+    if (!view->containment() || !timerStartUp.isActive())
+        return;
+
+    timerStartUp.stop();
+
+    //! the windows are checked against the dock before it syncs its geometry
+    if (dockGeometry.isEmpty())
+        setDockGeometry(geometry);
+
+    //! a dock that was hidden is hidden again without the hide delay
+    hideNow = wasHidden;
+    setMode(static_cast<Dock::Visibility>(view->containment()->config()
+                                          .readEntry("visibility", static_cast<int>(Dock::DodgeActive))));
+    hideNow = false;
+}
+
 void VisibilityManagerPrivate::viewEventManager(QEvent *ev)
 {
     switch (ev->type()) {
@@ -570,6 +589,11 @@ void VisibilityManager::setRaiseOnActivity(bool enable)
     d->setRaiseOnActivity(enable);
 }
 
+void VisibilityManager::applyHandoffState(bool wasHidden, const QRect &geometry)
+{
+    d->applyHandoffState(wasHidden, geometry);
+}
+
 bool VisibilityManager::isHidden() const
 {
     return d->isHidden;
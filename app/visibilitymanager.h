@@ -72,6 +72,10 @@ public:
     int timerHide() const;
     void setTimerHide(int msec);
 
+    //! continues from the state of the dock of a replaced latte-dock, which
+    //! had already settled, so the startup delay of the mode is skipped
+    void applyHandoffState(bool wasHidden, const QRect &geometry);
+
 signals:
     void mustBeShown(QPrivateSignal);
     void mustBeHide(QPrivateSignal);
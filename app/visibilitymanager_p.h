@@ -53,6 +53,7 @@ public:
 
     void saveConfig();
     void restoreConfig();
+    void applyHandoffState(bool wasHidden, const QRect &geometry);
 
     void viewEventManager(QEvent *ev);
 
@@ -0,0 +1,263 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//! runs ShmBufferPool against a headless compositor, a KWayland::Server
+//! display announcing wl_shm and wl_compositor in the same process
+
+#include "../app/shmbufferpool.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QThread>
+#include <QtTest>
+
+#include <KWayland/Client/buffer.h>
+#include <KWayland/Client/compositor.h>
+#include <KWayland/Client/connection_thread.h>
+#include <KWayland/Client/event_queue.h>
+#include <KWayland/Client/registry.h>
+#include <KWayland/Client/shm_pool.h>
+#include <KWayland/Client/surface.h>
+#include <KWayland/Server/compositor_interface.h>
+#include <KWayland/Server/display.h>
+#include <KWayland/Server/surface_interface.h>
+
+using namespace KWayland::Client;
+using namespace KWayland::Server;
+
+static const QString s_socketName = QStringLiteral("lattedock-shmbufferpool-test-0");
+
+class ShmBufferPoolTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testAcquirePaints();
+    void testInvalidRequests();
+    void testUsedBufferIsNotReused();
+    void testReleasedBufferIsReused();
+    void testReleaseAll();
+
+private:
+    //! attaches the buffer and waits until the compositor has committed it
+    void present(const Buffer::Ptr &buffer);
+
+    Display *m_display{nullptr};
+    CompositorInterface *m_compositorInterface{nullptr};
+    SurfaceInterface *m_surfaceInterface{nullptr};
+
+    ConnectionThread *m_connection{nullptr};
+    QThread *m_thread{nullptr};
+    EventQueue *m_queue{nullptr};
+    Compositor *m_compositor{nullptr};
+    ShmPool *m_shm{nullptr};
+    Surface *m_surface{nullptr};
+};
+
+void ShmBufferPoolTest::init()
+{
+    m_display = new Display(this);
+    m_display->setSocketName(s_socketName);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+    m_display->createShm();
+    m_compositorInterface = m_display->createCompositor(m_display);
+    m_compositorInterface->create();
+
+    m_connection = new ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &ConnectionThread::connected);
+    m_connection->setSocketName(s_socketName);
+    m_thread = new QThread(this);
+    m_connection->moveToThread(m_thread);
+    m_thread->start();
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new EventQueue(this);
+    m_queue->setup(m_connection);
+
+    Registry registry;
+    QSignalSpy announcedSpy(&registry, &Registry::interfacesAnnounced);
+    registry.setEventQueue(m_queue);
+    registry.create(m_connection);
+    registry.setup();
+    QVERIFY(announcedSpy.wait());
+
+    const auto shm = registry.interface(Registry::Interface::Shm);
+    m_shm = registry.createShmPool(shm.name, shm.version, this);
+    QVERIFY(m_shm->isValid());
+
+    const auto compositor = registry.interface(Registry::Interface::Compositor);
+    m_compositor = registry.createCompositor(compositor.name, compositor.version, this);
+    QVERIFY(m_compositor->isValid());
+
+    QSignalSpy surfaceSpy(m_compositorInterface, &CompositorInterface::surfaceCreated);
+    m_surface = m_compositor->createSurface(this);
+    m_connection->flush();
+    QVERIFY(surfaceSpy.wait());
+    m_surfaceInterface = surfaceSpy.first().first().value<SurfaceInterface *>();
+    QVERIFY(m_surfaceInterface);
+}
+
+void ShmBufferPoolTest::cleanup()
+{
+    delete m_surface;
+    m_surface = nullptr;
+    delete m_compositor;
+    m_compositor = nullptr;
+    delete m_shm;
+    m_shm = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+
+    if (m_connection) {
+        m_connection->deleteLater();
+        m_connection = nullptr;
+    }
+
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+
+    delete m_display;
+    m_display = nullptr;
+    m_compositorInterface = nullptr;
+    m_surfaceInterface = nullptr;
+}
+
+void ShmBufferPoolTest::present(const Buffer::Ptr &buffer)
+{
+    QSignalSpy committedSpy(m_surfaceInterface, &SurfaceInterface::committed);
+    m_surface->attachBuffer(buffer);
+    m_surface->damage(QRect(QPoint(0, 0), buffer.toStrongRef()->size()));
+    m_surface->commit(Surface::CommitFlag::None);
+    m_connection->flush();
+    QVERIFY(committedSpy.wait());
+}
+
+void ShmBufferPoolTest::testAcquirePaints()
+{
+    Latte::ShmBufferPool pool(m_shm);
+
+    auto buffer = pool.acquire(QSize(8, 4), [](QPainter * painter) {
+        painter->fillRect(QRect(0, 0, 4, 4), Qt::red);
+    }).toStrongRef();
+
+    QVERIFY(buffer);
+    QCOMPARE(buffer->size(), QSize(8, 4));
+    QVERIFY(buffer->isUsed());
+    QCOMPARE(pool.usedBuffers(), 1);
+
+    //! painted in the shm mapping, the rest is cleared to transparent
+    const QImage image(buffer->address(), 8, 4, 8 * 4, QImage::Format_ARGB32_Premultiplied);
+    QCOMPARE(image.pixel(0, 0), qRgba(255, 0, 0, 255));
+    QCOMPARE(image.pixel(7, 3), qRgba(0, 0, 0, 0));
+}
+
+void ShmBufferPoolTest::testInvalidRequests()
+{
+    Latte::ShmBufferPool pool(m_shm);
+    QVERIFY(!pool.acquire(QSize(), nullptr));
+    QVERIFY(!pool.acquire(QSize(0, 4), nullptr));
+
+    Latte::ShmBufferPool noPool(nullptr);
+    QVERIFY(!noPool.acquire(QSize(8, 8), nullptr));
+
+    QCOMPARE(pool.usedBuffers(), 0);
+    QCOMPARE(noPool.usedBuffers(), 0);
+}
+
+void ShmBufferPoolTest::testUsedBufferIsNotReused()
+{
+    Latte::ShmBufferPool pool(m_shm);
+
+    auto first = pool.acquire(QSize(16, 16), nullptr);
+    present(first);
+    auto second = pool.acquire(QSize(16, 16), nullptr);
+    present(second);
+
+    //! the compositor has released the first one but it is still in use
+    QTRY_VERIFY(first.toStrongRef()->isReleased());
+    auto third = pool.acquire(QSize(16, 16), nullptr);
+
+    QVERIFY(third);
+    QVERIFY(third != first);
+    QVERIFY(third != second);
+    QCOMPARE(pool.usedBuffers(), 3);
+}
+
+void ShmBufferPoolTest::testReleasedBufferIsReused()
+{
+    Latte::ShmBufferPool pool(m_shm);
+
+    auto first = pool.acquire(QSize(16, 16), nullptr);
+    present(first);
+    pool.release(first);
+    QVERIFY(!first.toStrongRef()->isUsed());
+    QCOMPARE(pool.usedBuffers(), 0);
+
+    //! the compositor still holds the first one
+    auto second = pool.acquire(QSize(16, 16), nullptr);
+    QVERIFY(second != first);
+    present(second);
+    QTRY_VERIFY(first.toStrongRef()->isReleased());
+
+    //! released by the pool and by the compositor, so it is handed out again
+    auto third = pool.acquire(QSize(16, 16), nullptr);
+    QCOMPARE(third, first);
+    QVERIFY(third.toStrongRef()->isUsed());
+
+    //! a different size is never matched
+    auto other = pool.acquire(QSize(8, 16), nullptr);
+    QVERIFY(other != first);
+    QVERIFY(other != second);
+    QCOMPARE(pool.usedBuffers(), 3);
+}
+
+void ShmBufferPoolTest::testReleaseAll()
+{
+    QList<Buffer::Ptr> buffers;
+
+    {
+        Latte::ShmBufferPool pool(m_shm);
+        buffers << pool.acquire(QSize(8, 8), nullptr) << pool.acquire(QSize(8, 8), nullptr);
+        QCOMPARE(pool.usedBuffers(), 2);
+
+        pool.releaseAll();
+        QCOMPARE(pool.usedBuffers(), 0);
+
+        buffers << pool.acquire(QSize(4, 4), nullptr);
+        QCOMPARE(pool.usedBuffers(), 1);
+    }
+
+    //! the destructor releases the buffers that are still used
+    foreach (const auto &buffer, buffers) {
+        QVERIFY(!buffer.toStrongRef()->isUsed());
+    }
+}
+
+QTEST_GUILESS_MAIN(ShmBufferPoolTest)
+#include "shmbufferpooltest.moc"
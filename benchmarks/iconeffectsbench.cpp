@@ -0,0 +1,273 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//! compares the IconEffects kernels against KIconEffect for the effects
+//! that IconItem uses for its active and disabled states. The output of
+//! each instruction set is verified against the scalar kernels first,
+//! --verify stops after that
+
+#include "iconeffects.h"
+
+#include <functional>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QTextStream>
+
+#include <KIconThemes/KIconEffect>
+
+namespace {
+
+QTextStream out(stdout);
+
+//! a translucent icon-like image with gradients, so no kernel path is skipped
+QImage sampleImage(int size)
+{
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QLinearGradient gradient(0, 0, size, size);
+    gradient.setColorAt(0, QColor(230, 60, 20, 255));
+    gradient.setColorAt(0.5, QColor(40, 200, 90, 180));
+    gradient.setColorAt(1, QColor(20, 80, 240, 90));
+    painter.setBrush(gradient);
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QRectF(1, 1, size - 2, size - 2));
+
+    return image;
+}
+
+//! nanoseconds for each call, the image is copied outside of the timed part
+qint64 measure(const QImage &source, int iterations, const std::function<void(QImage &)> &effect)
+{
+    qint64 total{0};
+    QElapsedTimer timer;
+
+    for (int i = 0; i < iterations; ++i) {
+        QImage image = source.copy();
+        timer.start();
+        effect(image);
+        total += timer.nsecsElapsed();
+    }
+
+    return total / iterations;
+}
+
+void report(const QString &name, int size, qint64 kiconeffect, qint64 latte)
+{
+    out << qSetFieldWidth(18) << left << name << qSetFieldWidth(6) << right << size
+        << qSetFieldWidth(12) << kiconeffect << latte
+        << qSetFieldWidth(10) << QString::number(latte > 0 ? double(kiconeffect) / latte : 0.0, 'f', 2)
+        << qSetFieldWidth(0) << endl;
+}
+
+//! premultiplied pixels with every kind of alpha, random but the same for each run
+QImage noiseImage(int width, int height)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    quint32 seed = width * 1000 + height;
+    //! the numbers in [from, to) of a linear congruential generator
+    const auto bounded = [&seed](quint32 from, quint32 to) {
+        seed = seed * 1664525u + 1013904223u;
+        return from + (seed >> 8) % (to - from);
+    };
+
+    for (int y = 0; y < height; ++y) {
+        quint32 *line = reinterpret_cast<quint32 *>(image.scanLine(y));
+
+        for (int x = 0; x < width; ++x) {
+            const quint32 kind = bounded(0, 4);
+            const quint32 alpha = kind == 0 ? 0 : (kind == 1 ? 255 : bounded(1, 255));
+            const auto c = [&]() {
+                return alpha == 0 ? 0 : bounded(0, alpha + 1);
+            };
+
+            line[x] = c() | (c() << 8) | (c() << 16) | (alpha << 24);
+        }
+    }
+
+    return image;
+}
+
+struct Effect {
+    QString name;
+    std::function<void(QImage &)> latte;
+    std::function<void(QImage &)> kiconeffect;
+};
+
+//! the largest difference of a channel, only for the pixels that are opaque
+//! in the source when it is given
+int maxDifference(const QImage &first, const QImage &second, const QImage &source = QImage())
+{
+    int difference{0};
+
+    for (int y = 0; y < first.height(); ++y) {
+        const quint32 *a = reinterpret_cast<const quint32 *>(first.constScanLine(y));
+        const quint32 *b = reinterpret_cast<const quint32 *>(second.constScanLine(y));
+        const quint32 *s = source.isNull() ? nullptr : reinterpret_cast<const quint32 *>(source.constScanLine(y));
+
+        for (int x = 0; x < first.width(); ++x) {
+            if (s && (s[x] >> 24) != 255) {
+                continue;
+            }
+
+            for (int shift = 0; shift < 32; shift += 8) {
+                difference = qMax(difference, qAbs(int((a[x] >> shift) & 0xff) - int((b[x] >> shift) & 0xff)));
+            }
+        }
+    }
+
+    return difference;
+}
+
+QString instructionSetName(Latte::IconEffects::InstructionSet isa)
+{
+    switch (isa) {
+        case Latte::IconEffects::Avx2:
+            return QStringLiteral("avx2");
+
+        case Latte::IconEffects::Sse2:
+            return QStringLiteral("sse2");
+
+        default:
+            return QStringLiteral("scalar");
+    }
+}
+
+//! the vector kernels must give the same bytes as the scalar ones, the odd
+//! widths leave tails that are not a multiple of the vector width.
+//! KIconEffect works on unpremultiplied data with integer math, so it is
+//! compared for the opaque pixels with a rounding tolerance
+bool verify(const QList<Effect> &effects, const QList<Latte::IconEffects::InstructionSet> &isas)
+{
+    const int KIconEffectTolerance{2};
+    const QList<QSize> sizes{{1, 1}, {3, 3}, {7, 5}, {9, 9}, {15, 4}, {17, 17}, {31, 3}, {33, 33}, {48, 48}, {255, 2}};
+    bool passed{true};
+
+    for (const QSize &size : sizes) {
+        const QImage image = noiseImage(size.width(), size.height());
+
+        for (const Effect &effect : effects) {
+            Latte::IconEffects::setInstructionSet(Latte::IconEffects::Scalar);
+            QImage scalar = image.copy();
+            effect.latte(scalar);
+
+            for (auto isa : isas) {
+                if (isa == Latte::IconEffects::Scalar || !Latte::IconEffects::setInstructionSet(isa)) {
+                    continue;
+                }
+
+                QImage vector = image.copy();
+                effect.latte(vector);
+
+                if (vector != scalar) {
+                    out << "FAIL " << effect.name << " " << size.width() << "x" << size.height() << ": "
+                        << instructionSetName(isa) << " differs from scalar by "
+                        << maxDifference(vector, scalar) << endl;
+                    passed = false;
+                }
+            }
+
+            QImage reference = image.convertToFormat(QImage::Format_ARGB32);
+            effect.kiconeffect(reference);
+            reference = reference.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            const int difference = maxDifference(reference, scalar, image);
+
+            if (difference > KIconEffectTolerance) {
+                out << "FAIL " << effect.name << " " << size.width() << "x" << size.height()
+                    << ": differs from KIconEffect by " << difference << endl;
+                passed = false;
+            }
+        }
+    }
+
+    out << "verification " << (passed ? "passed" : "failed") << endl;
+    return passed;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    const bool verifyOnly = app.arguments().contains(QStringLiteral("--verify"));
+    const int iterations = !verifyOnly && app.arguments().size() > 1 ? app.arguments().at(1).toInt() : 200;
+    const QColor color(169, 156, 255);
+    const QList<int> sizes{16, 22, 32, 48, 64, 96, 128, 256};
+    const QList<Latte::IconEffects::InstructionSet> isas{Latte::IconEffects::Scalar
+            , Latte::IconEffects::Sse2
+            , Latte::IconEffects::Avx2};
+
+    const QList<Effect> effects{
+        {QStringLiteral("togray"), [](QImage & i) { Latte::IconEffects::toGray(i, 1.0); }, [](QImage & i) { KIconEffect::toGray(i, 1.0); }}
+        , {QStringLiteral("desaturate"), [](QImage & i) { Latte::IconEffects::deSaturate(i, 0.5); }, [](QImage & i) { KIconEffect::deSaturate(i, 0.5); }}
+        , {QStringLiteral("colorize"), [&](QImage & i) { Latte::IconEffects::colorize(i, color, 0.8); }, [&](QImage & i) { KIconEffect::colorize(i, color, 0.8); }}
+        , {QStringLiteral("togamma"), [](QImage & i) { Latte::IconEffects::toGamma(i, 0.7); }, [](QImage & i) { KIconEffect::toGamma(i, 0.7); }}
+        , {QStringLiteral("semitransparent"), [](QImage & i) { Latte::IconEffects::semiTransparent(i); }, [](QImage & i) { KIconEffect::semiTransparent(i); }}
+    };
+
+    const Latte::IconEffects::InstructionSet bestIsa = Latte::IconEffects::instructionSet();
+    const bool verified = verify(effects, isas);
+    Latte::IconEffects::setInstructionSet(bestIsa);
+
+    if (!verified) {
+        return 1;
+    } else if (verifyOnly) {
+        return 0;
+    }
+
+    for (auto isa : isas) {
+        if (!Latte::IconEffects::setInstructionSet(isa)) {
+            continue;
+        }
+
+        out << endl << "instruction set: " << instructionSetName(isa)
+            << ", ns per call, average of " << iterations << " calls" << endl;
+        out << qSetFieldWidth(18) << left << "effect" << qSetFieldWidth(6) << right << "size"
+            << qSetFieldWidth(12) << "KIconEffect" << "Latte" << qSetFieldWidth(10) << "speedup"
+            << qSetFieldWidth(0) << endl;
+
+        for (int size : sizes) {
+            const QImage image = sampleImage(size);
+
+            report(QStringLiteral("togray"), size
+                   , measure(image, iterations, [](QImage & i) { KIconEffect::toGray(i, 1.0); })
+                   , measure(image, iterations, [](QImage & i) { Latte::IconEffects::toGray(i, 1.0); }));
+            report(QStringLiteral("desaturate"), size
+                   , measure(image, iterations, [](QImage & i) { KIconEffect::deSaturate(i, 0.5); })
+                   , measure(image, iterations, [](QImage & i) { Latte::IconEffects::deSaturate(i, 0.5); }));
+            report(QStringLiteral("colorize"), size
+                   , measure(image, iterations, [&](QImage & i) { KIconEffect::colorize(i, color, 0.8); })
+                   , measure(image, iterations, [&](QImage & i) { Latte::IconEffects::colorize(i, color, 0.8); }));
+            report(QStringLiteral("togamma"), size
+                   , measure(image, iterations, [](QImage & i) { KIconEffect::toGamma(i, 0.7); })
+                   , measure(image, iterations, [](QImage & i) { Latte::IconEffects::toGamma(i, 0.7); }));
+            report(QStringLiteral("semitransparent"), size
+                   , measure(image, iterations, [](QImage & i) { KIconEffect::semiTransparent(i); })
+                   , measure(image, iterations, [](QImage & i) { Latte::IconEffects::semiTransparent(i); }));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//! measures the IconItem paths for every kind of source: setSource(),
+//! loadPixmap() through updatePolish() and updatePaintNode(). The items live
+//! in an offscreen QQuickWindow that uses the software scene graph backend
+
+#include "iconitem.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QImage>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGNode>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QUrl>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    #include <QSGRendererInterface>
+#endif
+
+//!BEGIN allocation counting
+//! every heap allocation of the process goes through these
+static std::atomic<quint64> s_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++s_allocations;
+
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+//!END allocation counting
+
+namespace {
+
+QTextStream out(stdout);
+
+struct Result {
+    qint64 nsecs{0};
+    quint64 allocations{0};
+};
+
+//! average time and allocations for each call of operation
+Result measure(int iterations, const std::function<void(int)> &operation)
+{
+    Result result;
+    QElapsedTimer timer;
+    const quint64 allocations = s_allocations;
+    timer.start();
+
+    for (int i = 0; i < iterations; ++i) {
+        operation(i);
+    }
+
+    result.nsecs = timer.nsecsElapsed() / iterations;
+    result.allocations = (s_allocations - allocations) / iterations;
+
+    return result;
+}
+
+void report(const QString &operation, const QString &source, int size, const Result &result)
+{
+    out << qSetFieldWidth(16) << left << operation << source
+        << qSetFieldWidth(6) << right << size
+        << qSetFieldWidth(12) << result.nsecs << result.allocations
+        << qSetFieldWidth(0) << endl;
+}
+
+QImage sampleImage(int size)
+{
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(QColor(60, 120, 220));
+    painter.setPen(Qt::NoPen);
+    painter.drawRoundedRect(QRectF(1, 1, size - 2, size - 2), size / 8, size / 8);
+
+    return image;
+}
+
+//! the scene graph must have been initialized for the window in order for
+//! updatePaintNode() to create textures outside of a real frame
+void updatePaintNode(Latte::IconItem *item)
+{
+    QSGNode *node = item->updatePaintNode(nullptr, nullptr);
+    delete node;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+#else
+    qputenv("QMLSCENE_DEVICE", "softwarecontext");
+#endif
+
+    QGuiApplication app(argc, argv);
+    const int iterations = app.arguments().size() > 1 ? app.arguments().at(1).toInt() : 100;
+    const QString iconName = app.arguments().size() > 2 ? app.arguments().at(2) : QStringLiteral("system-file-manager");
+
+    QQuickWindow window;
+    window.resize(512, 512);
+    window.show();
+    //! renders one frame, this initializes the scene graph
+    window.grabWindow();
+
+    QTemporaryDir tempDir;
+    const QString imagePath = tempDir.path() + QStringLiteral("/icon.png");
+    sampleImage(256).save(imagePath);
+
+    const QList<QPair<QString, QVariant>> sources{
+        {QStringLiteral("theme-name"), iconName},
+        {QStringLiteral("file-url"), QUrl::fromLocalFile(imagePath).toString()},
+        {QStringLiteral("qicon"), QIcon::fromTheme(iconName)},
+        {QStringLiteral("qimage"), sampleImage(128)}
+    };
+    const QList<int> sizes{16, 22, 32, 48, 64, 96, 128, 256};
+
+    out << "ns and allocations per call, average of " << iterations << " calls" << endl;
+    out << qSetFieldWidth(16) << left << "operation" << "source"
+        << qSetFieldWidth(6) << right << "size"
+        << qSetFieldWidth(12) << "ns" << "allocations"
+        << qSetFieldWidth(0) << endl;
+
+    for (const auto &source : sources) {
+        for (int size : sizes) {
+            //! setSource() on a fresh item, the item creation is not measured
+            QList<Latte::IconItem *> items;
+
+            for (int i = 0; i < iterations; ++i) {
+                auto *item = new Latte::IconItem(window.contentItem());
+                item->setSize(QSizeF(size, size));
+                items.append(item);
+            }
+
+            report(QStringLiteral("setSource"), source.first, size, measure(iterations, [&](int i) {
+                items[i]->setSource(source.second);
+            }));
+
+            qDeleteAll(items);
+
+            Latte::IconItem item(window.contentItem());
+            item.setSize(QSizeF(size, size));
+            item.setSource(source.second);
+
+            //! a reload of the icon, e.g. after a theme change
+            report(QStringLiteral("loadPixmap"), source.first, size, measure(iterations, [&](int) {
+                QMetaObject::invokeMethod(&item, "schedulePixmapUpdate");
+                item.updatePolish();
+            }));
+
+            //! hovering toggles only the state effect
+            report(QStringLiteral("setActive"), source.first, size, measure(iterations, [&](int i) {
+                item.setActive(i % 2 == 0);
+                item.updatePolish();
+            }));
+
+            item.setActive(false);
+            item.updatePolish();
+
+            report(QStringLiteral("updatePaintNode"), source.first, size, measure(iterations, [&](int) {
+                QMetaObject::invokeMethod(&item, "schedulePixmapUpdate");
+                item.updatePolish();
+                updatePaintNode(&item);
+            }));
+        }
+
+        //! parabolic zoom, the size grows from 48 to 96px and back pixel by pixel
+        Latte::IconItem item(window.contentItem());
+        item.setSize(QSizeF(48, 48));
+        item.setSource(source.second);
+        item.updatePolish();
+
+        int zoomSize = 48;
+        int step = 1;
+
+        report(QStringLiteral("zoom-sweep"), source.first, 96, measure(iterations * 4, [&](int) {
+            if (zoomSize >= 96) {
+                step = -1;
+            } else if (zoomSize <= 48) {
+                step = 1;
+            }
+
+            zoomSize += step;
+            item.setSize(QSizeF(zoomSize, zoomSize));
+            item.updatePolish();
+            updatePaintNode(&item);
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//! measures the compilation of the QML files of the shell, containment and
+//! plasmoid packages, as it happens at startup. Every mode runs in its own
+//! process with an empty cache directory:
+//!   source       the files are parsed and compiled, QML_DISABLE_DISK_CACHE
+//!   precompiled  the .qmlc units that the build generated are loaded
+//! the packages of the build directory are used unless others are given
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QProcess>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QUrl>
+
+namespace {
+
+QTextStream out(stdout);
+
+QStringList qmlFiles(const QString &package)
+{
+    QStringList files;
+    QDirIterator it(package, {QStringLiteral("*.qml")}, QDir::Files, QDirIterator::Subdirectories);
+
+    while (it.hasNext()) {
+        files << it.next();
+    }
+
+    files.sort();
+    return files;
+}
+
+//! compiles every file of the package with a new engine, prints the
+//! time in ms, the files and the files that failed e.g. missing imports
+int run(const QStringList &packages)
+{
+    for (const auto &package : packages) {
+        const QStringList files = qmlFiles(package);
+        int errors{0};
+
+        QQmlEngine engine;
+        QElapsedTimer timer;
+        timer.start();
+
+        for (const auto &file : files) {
+            QQmlComponent component(&engine, QUrl::fromLocalFile(file));
+
+            if (component.isError()) {
+                ++errors;
+            }
+        }
+
+        out << timer.elapsed() << ' ' << files.count() << ' ' << errors << endl;
+    }
+
+    return 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+
+    if (args.value(0) == QLatin1String("--run")) {
+        return run(args.mid(1));
+    }
+
+    if (args.isEmpty()) {
+        for (const auto &package : {"shell", "containment", "plasmoid"}) {
+            args << QStringLiteral(PACKAGES_DIR "/%1/release/contents").arg(QLatin1String(package));
+        }
+    }
+
+    out << qSetFieldWidth(14) << left << "mode" << qSetFieldWidth(48) << "package"
+        << qSetFieldWidth(10) << right << "ms" << "files" << "errors" << qSetFieldWidth(0) << endl;
+
+    for (const auto &mode : {QStringLiteral("source"), QStringLiteral("precompiled")}) {
+        QTemporaryDir cache;
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QStringLiteral("XDG_CACHE_HOME"), cache.path());
+
+        if (mode == QLatin1String("source")) {
+            env.insert(QStringLiteral("QML_DISABLE_DISK_CACHE"), QStringLiteral("1"));
+        } else {
+            env.remove(QStringLiteral("QML_DISABLE_DISK_CACHE"));
+        }
+
+        QProcess process;
+        process.setProcessEnvironment(env);
+        process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        process.start(app.applicationFilePath(), QStringList{QStringLiteral("--run")} + args);
+        process.waitForFinished(-1);
+
+        const QStringList lines = QString::fromLocal8Bit(process.readAllStandardOutput()).split('\n', QString::SkipEmptyParts);
+
+        for (int i = 0; i < lines.count() && i < args.count(); ++i) {
+            const QStringList values = lines.at(i).split(' ');
+
+            out << qSetFieldWidth(14) << left << mode << qSetFieldWidth(48) << args.at(i)
+                << qSetFieldWidth(10) << right << values.value(0) << values.value(1) << values.value(2)
+                << qSetFieldWidth(0) << endl;
+        }
+    }
+
+    return 0;
+}
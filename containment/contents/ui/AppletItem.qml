@@ -764,7 +764,7 @@ Item {
             Loader{
                 anchors.fill: container.appletWrapper
 
-                active: container.applet
+                active: container.applet && !root.dockResourcesReleased
                         &&((plasmoid.configuration.shadows === 1 /*Locked Applets*/
                             && (!container.canBeHovered || (container.lockZoom && (applet.pluginName !== root.plasmoidName))) )
                            || (plasmoid.configuration.shadows === 2 /*All Applets*/
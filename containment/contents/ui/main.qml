@@ -196,6 +196,7 @@ DragDrop.DropArea {
 
     property bool enableShadows: plasmoid.configuration.shadows
     property bool dockIsHidden: dock ? dock.visibility.isHidden : true
+    property bool dockResourcesReleased: dock ? dock.resourcesReleased : false
     property bool dotsOnActive: plasmoid.configuration.dotsOnActive
     property bool highlightWindows: plasmoid.configuration.highlightWindows
     property bool reverseLinesPosition: plasmoid.configuration.reverseLinesPosition// latteApplet ? latteApplet.reverseLinesPosition : false
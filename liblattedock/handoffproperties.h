@@ -0,0 +1,38 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HANDOFFPROPERTIES_H
+#define HANDOFFPROPERTIES_H
+
+//! this header is shared between the lattedock plugin and latte-dock, which
+//! hands the plugin's caches from a replaced instance to the new one, it
+//! must stay header only
+
+namespace Latte {
+
+//! the name of the qApp property that holds the IconColors of the plugin
+const char IconColorsProperty[] = "_latte_iconColors";
+//! the name of the qApp property with the colors that the replaced instance
+//! handed off, IconColors takes them when it is created
+const char HandoffIconColorsProperty[] = "_latte_handoffIconColors";
+
+}
+
+#endif // HANDOFFPROPERTIES_H
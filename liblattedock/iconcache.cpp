@@ -0,0 +1,227 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "iconcache.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <cstring>
+
+#include <KIconThemes/KIconLoader>
+#include <KIconThemes/KIconTheme>
+
+#include <Plasma/Theme>
+
+namespace Latte {
+namespace IconCache {
+
+namespace {
+const char Magic[8] = {'L', 'A', 'T', 'T', 'E', 'I', 'C', '1'};
+
+//! 32 bytes, so the pixels that follow it stay 16 bytes aligned in the mapping
+struct Header {
+    char magic[8];
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    float devicePixelRatio;
+    quint32 reserved[2];
+};
+
+static_assert(sizeof(Header) == 32, "the icon cache header must be 32 bytes");
+
+//! when there are more entries than this the cache starts over
+const int MaxEntries = 2000;
+
+QString cacheDir()
+{
+    static const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                               + QStringLiteral("/lattedock/icons/");
+    return dir;
+}
+
+QString filePath(const QString &key)
+{
+    return cacheDir() + key + QStringLiteral(".icon");
+}
+
+//! one theme for all the lookups, constructing a Plasma::Theme for every
+//! key would cost more than the cache saves
+Plasma::Theme *theme()
+{
+    static Plasma::Theme *theme = new Plasma::Theme(QCoreApplication::instance());
+    return theme;
+}
+
+//! the svg icons follow the plasma theme colors, that part of the key
+//! is computed once and again only when the theme changes
+const QString &themeKey()
+{
+    static QString cached;
+    static bool connected{false};
+
+    if (!connected) {
+        connected = true;
+        QObject::connect(theme(), &Plasma::Theme::themeChanged, []() {
+            cached.clear();
+        });
+    }
+
+    if (cached.isEmpty()) {
+        cached = QStringList({
+            theme()->themeName(),
+            QString::number(theme()->color(Plasma::Theme::TextColor).rgba()),
+            QString::number(theme()->color(Plasma::Theme::BackgroundColor).rgba()),
+            QString::number(theme()->color(Plasma::Theme::HighlightColor).rgba())
+        }).join(QLatin1Char('|'));
+    }
+
+    return cached;
+}
+
+//! the QImage cleanup function, it unmaps the file when the image is released
+void closeMapping(void *file)
+{
+    delete static_cast<QFile *>(file);
+}
+}
+
+QString key(const QString &svgPath, const QString &iconName, int size, qreal devicePixelRatio, int state)
+{
+    QFileInfo info(svgPath);
+
+    if (!info.isAbsolute()) {
+        info = QFileInfo(theme()->imagePath(svgPath));
+    }
+
+    const auto *iconTheme = KIconLoader::global()->theme();
+
+    const QString id = QStringList({
+        iconTheme ? iconTheme->internalName() : QString(),
+        themeKey(),
+        info.absoluteFilePath(),
+        QString::number(info.lastModified().toMSecsSinceEpoch()),
+        iconName,
+        QString::number(size),
+        QString::number(devicePixelRatio),
+        QString::number(state)
+    }).join(QLatin1Char('|'));
+
+    return QString::fromLatin1(QCryptographicHash::hash(id.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+QImage load(const QString &key)
+{
+    QFile *file = new QFile(filePath(key));
+
+    if (!file->open(QIODevice::ReadOnly) || file->size() < static_cast<qint64>(sizeof(Header))) {
+        delete file;
+        return QImage();
+    }
+
+    const uchar *data = file->map(0, file->size());
+
+    if (!data) {
+        delete file;
+        return QImage();
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(data);
+
+    if (memcmp(header->magic, Magic, sizeof(Magic)) != 0
+        || header->width <= 0 || header->height <= 0 || header->bytesPerLine < header->width * 4
+        || file->size() < static_cast<qint64>(sizeof(Header)) + static_cast<qint64>(header->bytesPerLine) * header->height) {
+        qWarning() << "invalid icon cache entry" << file->fileName();
+        file->remove();
+        delete file;
+        return QImage();
+    }
+
+    //! the image uses the mapped pixels, the mapping lives as long as the image data
+    QImage image(data + sizeof(Header), header->width, header->height, header->bytesPerLine
+                 , QImage::Format_ARGB32_Premultiplied, closeMapping, file);
+    image.setDevicePixelRatio(header->devicePixelRatio);
+
+    return image;
+}
+
+void store(const QString &key, const QImage &source)
+{
+    if (source.isNull()) {
+        return;
+    }
+
+    QDir dir(cacheDir());
+
+    if (!dir.exists() && !dir.mkpath(QStringLiteral("."))) {
+        return;
+    }
+
+    if (dir.count() > MaxEntries) {
+        clear();
+        dir.mkpath(QStringLiteral("."));
+    }
+
+    const QImage image = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    Header header;
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.width = image.width();
+    header.height = image.height();
+    header.bytesPerLine = image.width() * 4;
+    header.devicePixelRatio = static_cast<float>(image.devicePixelRatio());
+    header.reserved[0] = header.reserved[1] = 0;
+
+    QSaveFile file(filePath(key));
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+    for (int y = 0; y < image.height(); ++y) {
+        file.write(reinterpret_cast<const char *>(image.constScanLine(y)), header.bytesPerLine);
+    }
+
+    if (!file.commit()) {
+        qWarning() << "icon cache entry could not be saved" << file.fileName();
+    }
+}
+
+void clear()
+{
+    QDir dir(cacheDir());
+
+    if (dir.exists()) {
+        dir.removeRecursively();
+    }
+}
+
+}
+}
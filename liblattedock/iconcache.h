@@ -0,0 +1,59 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QImage>
+#include <QString>
+
+namespace Latte {
+
+/**
+ * @brief On-disk cache of rasterized svg icons, so the first frame of the
+ * dock does not need to parse and render every svg again.
+ *
+ * Each entry is one file in the user cache directory with a small header
+ * and the premultiplied ARGB32 pixels, which are mapped in memory and used
+ * by the returned QImage without copying them.
+ */
+namespace IconCache {
+
+/*!
+ * @brief the key of an icon, the modification time of the svg file and
+ * the plasma theme are part of it, so changed icons are never matched
+ */
+QString key(const QString &svgPath, const QString &iconName, int size, qreal devicePixelRatio, int state);
+
+/*!
+ * @brief the cached image, a null image if there is no valid entry
+ */
+QImage load(const QString &key);
+
+void store(const QString &key, const QImage &image);
+
+//! removes all the entries, e.g. when the icon theme or its settings change
+void clear();
+
+}
+
+}
+
+#endif // ICONCACHE_H
@@ -0,0 +1,288 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "iconcolors.h"
+#include "handoffproperties.h"
+#include "startuptrace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QRunnable>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
+namespace Latte {
+
+namespace {
+//! 4 bits for each channel
+const int Bins = 4096;
+//! pixels with alpha below 128 are not counted in the histogram
+const int SkipBin = Bins;
+
+inline int binOf(quint32 pixel)
+{
+    if (pixel < 0x80000000) {
+        return SkipBin;
+    }
+
+    return ((pixel >> 12) & 0xf00) | ((pixel >> 8) & 0xf0) | ((pixel >> 4) & 0xf);
+}
+
+class ColorsJob : public QRunnable {
+public:
+    ColorsJob(IconColors *service, const QString &key, const QImage &image, int generation)
+        : m_service(service),
+          m_generation(generation),
+          m_key(key),
+          m_image(image) {
+    }
+
+    void run() override {
+        const IconColors::Colors colors = IconColors::compute(m_image);
+        QMetaObject::invokeMethod(m_service, "setColors", Qt::QueuedConnection
+                                  , Q_ARG(QString, m_key)
+                                  , Q_ARG(QColor, colors.average)
+                                  , Q_ARG(QColor, colors.dominant)
+                                  , Q_ARG(int, m_generation));
+    }
+
+private:
+    IconColors *m_service;
+    int m_generation;
+    QString m_key;
+    QImage m_image;
+};
+}
+
+const QString IconColors::PixmapKeyPrefix = QStringLiteral("pixmap:");
+
+IconColors::IconColors(QObject *parent)
+    : QObject(parent),
+      m_cache(1000)
+{
+    //! colors are not urgent, one low priority thread is enough
+    m_pool.setMaxThreadCount(1);
+
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        app->setProperty(IconColorsProperty, QVariant::fromValue<QObject *>(this));
+        importColors(app->property(HandoffIconColorsProperty).toList());
+        app->setProperty(HandoffIconColorsProperty, QVariant());
+    }
+}
+
+IconColors *IconColors::self()
+{
+    static IconColors instance;
+    return &instance;
+}
+
+IconColors::Colors IconColors::colors(const QString &key) const
+{
+    if (Colors *colors = m_cache.object(key)) {
+        return *colors;
+    }
+
+    return Colors();
+}
+
+void IconColors::request(const QString &key, const QImage &image)
+{
+    if (key.isEmpty() || image.isNull() || m_cache.contains(key) || m_pending.contains(key)) {
+        return;
+    }
+
+    m_pending.insert(key);
+    m_pool.start(new ColorsJob(this, key, image, m_generation), QThread::LowPriority);
+}
+
+void IconColors::clear()
+{
+    m_cache.clear();
+    //! the jobs in flight are for the old icons, their keys can be requested again
+    m_pending.clear();
+    ++m_generation;
+}
+
+QVariantList IconColors::exportColors() const
+{
+    QVariantList colors;
+
+    foreach (const QString &key, m_cache.keys()) {
+        if (key.startsWith(PixmapKeyPrefix)) {
+            continue;
+        }
+
+        const Colors *cached = m_cache.object(key);
+        colors << QVariant(QVariantList({key, cached->average, cached->dominant}));
+    }
+
+    return colors;
+}
+
+void IconColors::importColors(const QVariantList &colors)
+{
+    foreach (const QVariant &entry, colors) {
+        const QVariantList fields = entry.toList();
+
+        if (fields.size() != 3 || fields[0].toString().isEmpty()) {
+            continue;
+        }
+
+        m_cache.insert(fields[0].toString(), new Colors{fields[1].value<QColor>(), fields[2].value<QColor>()});
+    }
+
+    if (!colors.isEmpty()) {
+        qDebug() << "icon colors handed off:" << m_cache.size();
+    }
+}
+
+void IconColors::setColors(const QString &key, const QColor &average, const QColor &dominant, int generation)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_pending.remove(key);
+    m_cache.insert(key, new Colors{average, dominant});
+
+    emit colorsReady(key);
+}
+
+IconColors::Colors IconColors::compute(const QImage &source)
+{
+    LATTE_TRACE_SCOPE("IconColors::compute");
+
+    const QImage image = source.convertToFormat(QImage::Format_ARGB32);
+    const int width = image.width();
+
+    //! four histograms, so consecutive pixels of the same color do not wait
+    //! for each other's increments. The last bin collects the skipped pixels
+    std::vector<quint32> counts(4 * (Bins + 1), 0);
+    std::vector<quint64> binSums(3 * Bins, 0);
+    quint64 sums[3] = {0, 0, 0};
+    quint64 alphaSum = 0;
+
+    for (int y = 0; y < image.height(); ++y) {
+        const quint32 *line = reinterpret_cast<const quint32 *>(image.constScanLine(y));
+        int bins[4];
+        int x = 0;
+
+        while (x < width) {
+            const int block = std::min(4, width - x);
+#ifdef __SSE2__
+
+            if (block == 4) {
+                //! bin = (r >> 4) << 8 | (g >> 4) << 4 | b >> 4, or SkipBin
+                //! for the pixels whose alpha has not its high bit set
+                const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(line + x));
+                const __m128i bin = _mm_or_si128(_mm_or_si128(
+                                                     _mm_and_si128(_mm_srli_epi32(px, 12), _mm_set1_epi32(0xf00)),
+                                                     _mm_and_si128(_mm_srli_epi32(px, 8), _mm_set1_epi32(0xf0))),
+                                                 _mm_and_si128(_mm_srli_epi32(px, 4), _mm_set1_epi32(0xf)));
+                const __m128i opaque = _mm_srai_epi32(px, 31);
+                const __m128i result = _mm_or_si128(_mm_and_si128(opaque, bin),
+                                                    _mm_andnot_si128(opaque, _mm_set1_epi32(SkipBin)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(bins), result);
+            } else
+#endif
+            {
+                for (int i = 0; i < block; ++i) {
+                    bins[i] = binOf(line[x + i]);
+                }
+            }
+
+            for (int i = 0; i < block; ++i) {
+                const quint32 pixel = line[x + i];
+                const quint32 alpha = pixel >> 24;
+                const quint32 rgb[3] = {(pixel >> 16) & 0xff, (pixel >> 8) & 0xff, pixel & 0xff};
+
+                ++counts[i * (Bins + 1) + bins[i]];
+
+                for (int c = 0; c < 3; ++c) {
+                    sums[c] += rgb[c] * alpha;
+                }
+
+                alphaSum += alpha;
+
+                if (bins[i] != SkipBin) {
+                    for (int c = 0; c < 3; ++c) {
+                        binSums[3 * bins[i] + c] += rgb[c];
+                    }
+                }
+            }
+
+            x += block;
+        }
+    }
+
+    Colors colors;
+
+    if (alphaSum == 0) {
+        return colors;
+    }
+
+    colors.average = QColor(static_cast<int>(sums[0] / alphaSum),
+                            static_cast<int>(sums[1] / alphaSum),
+                            static_cast<int>(sums[2] / alphaSum));
+
+    //! the most frequent bin, colorful bins are preferred over gray ones
+    //! because icons usually have gray outlines and shades
+    int dominantBin = -1;
+    quint32 dominantCount = 0;
+    float bestScore = 0;
+
+    for (int bin = 0; bin < Bins; ++bin) {
+        const quint32 count = counts[bin] + counts[(Bins + 1) + bin]
+                              + counts[2 * (Bins + 1) + bin] + counts[3 * (Bins + 1) + bin];
+
+        if (count == 0) {
+            continue;
+        }
+
+        const int r = (bin >> 8) & 0xf;
+        const int g = (bin >> 4) & 0xf;
+        const int b = bin & 0xf;
+        const float saturation = (std::max({r, g, b}) - std::min({r, g, b})) / 15.0f;
+        const float score = count * (0.25f + saturation);
+
+        if (score > bestScore) {
+            bestScore = score;
+            dominantBin = bin;
+            dominantCount = count;
+        }
+    }
+
+    if (dominantBin >= 0) {
+        colors.dominant = QColor(static_cast<int>(binSums[3 * dominantBin] / dominantCount),
+                                 static_cast<int>(binSums[3 * dominantBin + 1] / dominantCount),
+                                 static_cast<int>(binSums[3 * dominantBin + 2] / dominantCount));
+    } else {
+        colors.dominant = colors.average;
+    }
+
+    return colors;
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ICONCOLORS_H
+#define ICONCOLORS_H
+
+#include <QCache>
+#include <QColor>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QVariantList>
+
+namespace Latte {
+
+/**
+ * @brief The IconColors class, computes the average and the dominant
+ * color of icons in a worker thread and caches them for each icon key.
+ * It is used by IconItem, the colors are requested once for each icon
+ * and they are read from the cache afterwards.
+ */
+class IconColors final : public QObject {
+    Q_OBJECT
+
+public:
+    struct Colors {
+        QColor average;
+        QColor dominant;
+    };
+
+    static IconColors *self();
+
+    /*!
+     * @brief the cached colors for that key, invalid colors when they
+     * are not computed yet
+     */
+    Colors colors(const QString &key) const;
+
+    /*!
+     * @brief computes the colors of the image in the worker thread,
+     * colorsReady(key) is emitted when they are available. Cached or
+     * pending keys are not computed again
+     */
+    void request(const QString &key, const QImage &image);
+
+    //! the keys of pixmaps without an icon name start with it
+    static const QString PixmapKeyPrefix;
+
+    void clear();
+
+    //! the cached colors as [key, average, dominant] lists, for the handoff
+    //! to a new latte-dock. The keys of unnamed pixmaps are left out, they
+    //! are valid only in this process
+    Q_INVOKABLE QVariantList exportColors() const;
+
+    //! the calculation itself, it is thread safe
+    static Colors compute(const QImage &image);
+
+signals:
+    void colorsReady(const QString &key);
+
+private slots:
+    void setColors(const QString &key, const QColor &average, const QColor &dominant, int generation);
+
+private:
+    explicit IconColors(QObject *parent = nullptr);
+
+    void importColors(const QVariantList &colors);
+
+    QCache<QString, Colors> m_cache;
+    QSet<QString> m_pending;
+    //! increased by clear(), the results of older requests are dropped
+    int m_generation{0};
+    QThreadPool m_pool;
+};
+
+}
+
+#endif // ICONCOLORS_H
@@ -0,0 +1,604 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "iconeffects.h"
+#include "../app/config-latte.h"
+#include "iconeffects_p.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+#include <KIconThemes/KIconEffect>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
+namespace Latte {
+namespace IconEffects {
+
+using namespace Private;
+
+//!BEGIN scalar kernels
+namespace {
+inline quint32 packPixel(float b, float g, float r, float a)
+{
+    const auto clamp = [](float c) -> quint32 {
+        return static_cast<quint32>(std::lrint(std::min(std::max(c, 0.0f), 255.0f)));
+    };
+
+    return clamp(b) | (clamp(g) << 8) | (clamp(r) << 16) | (clamp(a) << 24);
+}
+
+inline float channel(quint32 pixel, int shift)
+{
+    return static_cast<float>((pixel >> shift) & 0xff);
+}
+
+inline quint32 toGrayPixel(quint32 pixel, const KernelParams &params)
+{
+    const float b = channel(pixel, 0);
+    const float g = channel(pixel, 8);
+    const float r = channel(pixel, 16);
+    const float gray = b * GrayB + g * GrayG + r * GrayR;
+    const float v = params.value;
+
+    return packPixel(b + (gray - b) * v, g + (gray - g) * v, r + (gray - r) * v, channel(pixel, 24));
+}
+
+//! lowering the HSV saturation keeps hue and value, so each channel
+//! moves towards the maximum one
+inline quint32 deSaturatePixel(quint32 pixel, const KernelParams &params)
+{
+    const float b = channel(pixel, 0);
+    const float g = channel(pixel, 8);
+    const float r = channel(pixel, 16);
+    const float max = std::max(std::max(b, g), r);
+    const float v = params.value;
+
+    return packPixel(b + (max - b) * v, g + (max - g) * v, r + (max - r) * v, channel(pixel, 24));
+}
+
+//! KIconEffect::colorize() rewritten for premultiplied data, the constant
+//! parts of the dark/light ramps are scaled by the pixel alpha
+inline quint32 colorizePixel(quint32 pixel, const KernelParams &params)
+{
+    const float src[3] = {channel(pixel, 0), channel(pixel, 8), channel(pixel, 16)};
+    const float a = channel(pixel, 24);
+    const float gray = src[0] * GrayB + src[1] * GrayG + src[2] * GrayR;
+    const float threshold = a * (128.0f / 255.0f);
+    const float v = params.value;
+    float out[3];
+
+    for (int i = 0; i < 3; ++i) {
+        float c = gray < threshold ? gray * params.colorLo[i]
+                  : (gray - threshold) * params.colorHi[i] + a * params.colorAdd[i];
+        c = std::min(std::max(c, 0.0f), a);
+        out[i] = src[i] + (c - src[i]) * v;
+    }
+
+    return packPixel(out[0], out[1], out[2], a);
+}
+
+inline quint32 toGammaPixel(quint32 pixel, const KernelParams &params)
+{
+    const quint32 a = pixel >> 24;
+
+    if (a == 0) {
+        return pixel;
+    } else if (a == 255) {
+        return static_cast<quint32>(params.gammaTable[pixel & 0xff])
+               | (static_cast<quint32>(params.gammaTable[(pixel >> 8) & 0xff]) << 8)
+               | (static_cast<quint32>(params.gammaTable[(pixel >> 16) & 0xff]) << 16)
+               | (pixel & 0xff000000);
+    }
+
+    quint32 result = pixel & 0xff000000;
+
+    for (int shift = 0; shift < 24; shift += 8) {
+        const quint32 c = std::min<quint32>((((pixel >> shift) & 0xff) * 255 + a / 2) / a, 255);
+        result |= ((static_cast<quint32>(params.gammaTable[c]) * a + 127) / 255) << shift;
+    }
+
+    return result;
+}
+
+//! halves the alpha, all the channels for premultiplied pixels
+inline quint32 semiTransparentPixel(quint32 pixel)
+{
+    return (pixel >> 1) & 0x7f7f7f7f;
+}
+
+inline quint32 applyPixel(Kernel kernel, quint32 pixel, const KernelParams &params)
+{
+    switch (kernel) {
+        case ToGrayKernel:
+            return toGrayPixel(pixel, params);
+
+        case ColorizeKernel:
+            return colorizePixel(pixel, params);
+
+        case ToGammaKernel:
+            return toGammaPixel(pixel, params);
+
+        case DeSaturateKernel:
+            return deSaturatePixel(pixel, params);
+
+        case SemiTransparentKernel:
+            return semiTransparentPixel(pixel);
+    }
+
+    return pixel;
+}
+
+}
+
+void Private::runScalar(Kernel kernel, quint32 *data, int count, const KernelParams &params)
+{
+    for (int i = 0; i < count; ++i) {
+        data[i] = applyPixel(kernel, data[i], params);
+    }
+}
+//!END scalar kernels
+
+#ifdef __SSE2__
+namespace {
+//! one pixel for each __m128, four pixels for each block
+struct Sse2Traits {
+    using F = __m128;
+    static const int PixelsPerBlock = 4;
+
+    static inline F zero() { return _mm_setzero_ps(); }
+    static inline F splat(float v) { return _mm_set1_ps(v); }
+    static inline F set(float b, float g, float r, float a) { return _mm_setr_ps(b, g, r, a); }
+    static inline F add(F a, F b) { return _mm_add_ps(a, b); }
+    static inline F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static inline F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static inline F min(F a, F b) { return _mm_min_ps(a, b); }
+    static inline F max(F a, F b) { return _mm_max_ps(a, b); }
+    static inline F lessThan(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static inline F select(F mask, F a, F b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    static inline F swapPairs(F v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+    static inline F swapHalves(F v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+    static inline F alpha(F v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+    static inline F colorMask() { return _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)); }
+
+    static inline void load(const quint32 *data, F px[4]) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+        const __m128i lo = _mm_unpacklo_epi8(in, zero);
+        const __m128i hi = _mm_unpackhi_epi8(in, zero);
+        px[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+        px[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+        px[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+        px[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+    }
+
+    static inline void store(quint32 *data, const F px[4]) {
+        const __m128i lo = _mm_packs_epi32(_mm_cvtps_epi32(px[0]), _mm_cvtps_epi32(px[1]));
+        const __m128i hi = _mm_packs_epi32(_mm_cvtps_epi32(px[2]), _mm_cvtps_epi32(px[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data), _mm_packus_epi16(lo, hi));
+    }
+};
+
+void semiTransparentSse2(quint32 *data, int count)
+{
+    const int vectorCount = count - count % 4;
+    const __m128i mask = _mm_set1_epi32(0x7f7f7f7f);
+
+    for (int i = 0; i < vectorCount; i += 4) {
+        __m128i *p = reinterpret_cast<__m128i *>(data + i);
+        _mm_storeu_si128(p, _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128(p), 1), mask));
+    }
+
+    runScalar(SemiTransparentKernel, data + vectorCount, count - vectorCount, KernelParams());
+}
+}
+#endif
+
+static InstructionSet supportedInstructionSet()
+{
+#if HAVE_AVX2 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        return Avx2;
+    }
+
+#endif
+#ifdef __SSE2__
+    return Sse2;
+#else
+    return Scalar;
+#endif
+}
+
+static InstructionSet s_instructionSet = supportedInstructionSet();
+
+InstructionSet instructionSet()
+{
+    return s_instructionSet;
+}
+
+bool setInstructionSet(InstructionSet isa)
+{
+    if (isa > supportedInstructionSet()) {
+        return false;
+    }
+
+    s_instructionSet = isa;
+    return true;
+}
+
+static void run(Kernel kernel, QImage &image, const KernelParams &params)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    if (image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    //! scanlines of 32bit images are contiguous, but avoid relying on it
+    const bool contiguous = image.bytesPerLine() == image.width() * 4;
+    const int rows = contiguous ? 1 : image.height();
+    const int count = contiguous ? image.width() * image.height() : image.width();
+
+    for (int y = 0; y < rows; ++y) {
+        quint32 *data = reinterpret_cast<quint32 *>(image.scanLine(y));
+
+        switch (s_instructionSet) {
+#if HAVE_AVX2
+
+            case Avx2:
+                runAvx2(kernel, data, count, params);
+                break;
+#endif
+#ifdef __SSE2__
+
+            case Sse2:
+                if (kernel == SemiTransparentKernel) {
+                    semiTransparentSse2(data, count);
+                } else {
+                    VectorKernels<Sse2Traits>::run(kernel, data, count, params);
+                }
+
+                break;
+#endif
+
+            default:
+                runScalar(kernel, data, count, params);
+                break;
+        }
+    }
+}
+
+void toGray(QImage &image, float value)
+{
+    KernelParams params;
+    params.value = qBound(0.0f, value, 1.0f);
+    run(ToGrayKernel, image, params);
+}
+
+void colorize(QImage &image, const QColor &color, float value)
+{
+    KernelParams params;
+    params.value = qBound(0.0f, value, 1.0f);
+    const int rgb[3] = {color.blue(), color.green(), color.red()};
+
+    for (int i = 0; i < 3; ++i) {
+        params.colorLo[i] = rgb[i] / 128.0f;
+        params.colorHi[i] = (256 - rgb[i]) / 128.0f;
+        params.colorAdd[i] = (rgb[i] - 1) / 255.0f;
+    }
+
+    run(ColorizeKernel, image, params);
+}
+
+void toGamma(QImage &image, float value)
+{
+    KernelParams params;
+    const float gamma = 1.0f / (2.0f * value + 0.5f);
+
+    for (int i = 0; i < 256; ++i) {
+        params.gammaTable[i] = qBound(0, static_cast<int>(std::pow(i / 255.0f, gamma) * 255.0f + 0.5f), 255);
+    }
+
+    run(ToGammaKernel, image, params);
+}
+
+void deSaturate(QImage &image, float value)
+{
+    KernelParams params;
+    params.value = qBound(0.0f, value, 1.0f);
+    run(DeSaturateKernel, image, params);
+}
+
+void semiTransparent(QImage &image)
+{
+    run(SemiTransparentKernel, image, KernelParams());
+}
+
+//!BEGIN shadow
+//! running sum box blur of count values, values outside of the range are 0
+static void boxBlur(const float *in, float *out, int count, int stride, int boxRadius)
+{
+    const float scale = 1.0f / (2 * boxRadius + 1);
+    float sum = 0;
+
+    for (int i = 0; i < boxRadius && i < count; ++i) {
+        sum += in[i * stride];
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (i + boxRadius < count) {
+            sum += in[(i + boxRadius) * stride];
+        }
+
+        out[i * stride] = sum * scale;
+
+        if (i - boxRadius >= 0) {
+            sum -= in[(i - boxRadius) * stride];
+        }
+    }
+}
+
+#ifdef __SSE2__
+//! the vertical pass of four adjacent columns at once
+static void boxBlurColumnsSse2(const float *in, float *out, int count, int stride, int boxRadius)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / (2 * boxRadius + 1));
+    __m128 sum = _mm_setzero_ps();
+
+    for (int i = 0; i < boxRadius && i < count; ++i) {
+        sum = _mm_add_ps(sum, _mm_loadu_ps(in + i * stride));
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (i + boxRadius < count) {
+            sum = _mm_add_ps(sum, _mm_loadu_ps(in + (i + boxRadius) * stride));
+        }
+
+        _mm_storeu_ps(out + i * stride, _mm_mul_ps(sum, scale));
+
+        if (i - boxRadius >= 0) {
+            sum = _mm_sub_ps(sum, _mm_loadu_ps(in + (i - boxRadius) * stride));
+        }
+    }
+}
+#endif
+
+QImage shadow(const QImage &source, int radius, const QColor &color)
+{
+    if (source.isNull()) {
+        return QImage();
+    }
+
+    radius = qMax(0, radius);
+    const QImage image = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const int width = image.width() + 2 * radius;
+    const int height = image.height() + 2 * radius;
+
+    std::vector<float> alpha(static_cast<size_t>(width) * height, 0.0f);
+    std::vector<float> buffer(alpha.size());
+
+    for (int y = 0; y < image.height(); ++y) {
+        const quint32 *line = reinterpret_cast<const quint32 *>(image.constScanLine(y));
+        float *row = alpha.data() + (y + radius) * width + radius;
+
+        for (int x = 0; x < image.width(); ++x) {
+            row[x] = line[x] >> 24;
+        }
+    }
+
+    //! DropShadow uses deviation = (radius + 1) / 3.33, three box passes of
+    //! boxRadius have a variance of boxRadius * (boxRadius + 1)
+    const float deviation = (radius + 1) / 3.33f;
+    const int boxRadius = qMax(1, qRound(std::sqrt(deviation * deviation + 0.25f) - 0.5f));
+
+    for (int pass = 0; pass < 3 && radius > 0; ++pass) {
+        for (int y = 0; y < height; ++y) {
+            boxBlur(alpha.data() + y * width, buffer.data() + y * width, width, 1, boxRadius);
+        }
+
+        int x = 0;
+#ifdef __SSE2__
+
+        if (s_instructionSet != Scalar) {
+            for (; x + 4 <= width; x += 4) {
+                boxBlurColumnsSse2(buffer.data() + x, alpha.data() + x, height, width, boxRadius);
+            }
+        }
+
+#endif
+
+        for (; x < width; ++x) {
+            boxBlur(buffer.data() + x, alpha.data() + x, height, width, boxRadius);
+        }
+    }
+
+    QImage result(width, height, QImage::Format_ARGB32_Premultiplied);
+    const float opacity = static_cast<float>(color.alphaF()) / 255.0f;
+    const float rgb[3] = {static_cast<float>(color.red()), static_cast<float>(color.green()), static_cast<float>(color.blue())};
+
+    for (int y = 0; y < height; ++y) {
+        quint32 *line = reinterpret_cast<quint32 *>(result.scanLine(y));
+        const float *row = alpha.data() + y * width;
+
+        for (int x = 0; x < width; ++x) {
+            const float a = std::min(row[x], 255.0f) * opacity;
+            line[x] = qRgba(qRound(rgb[0] * a), qRound(rgb[1] * a), qRound(rgb[2] * a), qRound(a * 255.0f));
+        }
+    }
+
+    result.setDevicePixelRatio(source.devicePixelRatio());
+
+    return result;
+}
+//!END shadow
+
+//!BEGIN settings
+//! same defaults and entries as KIconEffect::init() for the Desktop group
+static Settings readSettings(KIconLoader::States state)
+{
+    Settings result;
+    QString prefix;
+
+    switch (state) {
+        case KIconLoader::ActiveState:
+            prefix = QStringLiteral("Active");
+            result.effect = ToGamma;
+            result.value = 0.7f;
+            result.color = QColor(169, 156, 255);
+            break;
+
+        case KIconLoader::DisabledState:
+            prefix = QStringLiteral("Disabled");
+            result.effect = ToGray;
+            result.semiTransparent = true;
+            result.color = QColor(34, 202, 0);
+            break;
+
+        default:
+            prefix = QStringLiteral("Default");
+            result.color = QColor(144, 128, 248);
+            break;
+    }
+
+    result.color2 = QColor(0, 0, 0);
+
+    KConfigGroup cg(KSharedConfig::openConfig(), QStringLiteral("DesktopIcons"));
+    const QString effect = cg.readEntry(prefix + QLatin1String("Effect"), QString());
+
+    if (effect == QLatin1String("togray")) {
+        result.effect = ToGray;
+    } else if (effect == QLatin1String("colorize")) {
+        result.effect = Colorize;
+    } else if (effect == QLatin1String("desaturate")) {
+        result.effect = DeSaturate;
+    } else if (effect == QLatin1String("togamma")) {
+        result.effect = ToGamma;
+    } else if (effect == QLatin1String("tomonochrome")) {
+        result.effect = ToMonochrome;
+    } else if (effect == QLatin1String("none")) {
+        result.effect = NoEffect;
+    } else {
+        //! no user settings, keep the defaults
+        return result;
+    }
+
+    result.value = cg.readEntry(prefix + QLatin1String("Value"), 0.0);
+    result.color = cg.readEntry(prefix + QLatin1String("Color"), QColor());
+    result.color2 = cg.readEntry(prefix + QLatin1String("Color2"), QColor());
+    result.semiTransparent = cg.readEntry(prefix + QLatin1String("SemiTransparent"), false);
+
+    return result;
+}
+
+static Settings s_settings[KIconLoader::LastState];
+static bool s_settingsLoaded{false};
+
+Settings settings(KIconLoader::States state)
+{
+    if (!s_settingsLoaded) {
+        for (int i = 0; i < KIconLoader::LastState; ++i) {
+            s_settings[i] = readSettings(static_cast<KIconLoader::States>(i));
+        }
+
+        s_settingsLoaded = true;
+    }
+
+    return state < KIconLoader::LastState ? s_settings[state] : Settings();
+}
+
+void invalidateSettings()
+{
+    s_settingsLoaded = false;
+}
+//!END settings
+
+bool isSupported(const Settings &settings)
+{
+    return settings.effect != ToMonochrome;
+}
+
+bool apply(QImage &image, const Settings &settings)
+{
+    if (!isSupported(settings)) {
+        return false;
+    }
+
+    switch (settings.effect) {
+        case ToGray:
+            toGray(image, settings.value);
+            break;
+
+        case Colorize:
+            colorize(image, settings.color, settings.value);
+            break;
+
+        case ToGamma:
+            toGamma(image, settings.value);
+            break;
+
+        case DeSaturate:
+            deSaturate(image, settings.value);
+            break;
+
+        default:
+            break;
+    }
+
+    if (settings.semiTransparent) {
+        semiTransparent(image);
+    }
+
+    return true;
+}
+
+QPixmap apply(const QPixmap &pixmap, KIconLoader::States state)
+{
+    const Settings stateSettings = settings(state);
+
+    if (pixmap.isNull() || stateSettings.isNull()) {
+        return pixmap;
+    }
+
+    if (!isSupported(stateSettings)) {
+        return KIconLoader::global()->iconEffect()->apply(pixmap, KIconLoader::Desktop, state);
+    }
+
+    QImage image = pixmap.toImage();
+    apply(image, stateSettings);
+
+    QPixmap result = QPixmap::fromImage(image);
+    result.setDevicePixelRatio(pixmap.devicePixelRatio());
+
+    return result;
+}
+
+}
+}
@@ -0,0 +1,119 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ICONEFFECTS_H
+#define ICONEFFECTS_H
+
+#include <QColor>
+#include <QImage>
+#include <QPixmap>
+
+#include <KIconThemes/KIconLoader>
+
+namespace Latte {
+
+/**
+ * @brief Latte's own implementation of the KIconEffect effects that are
+ * used for the active and disabled icon states.
+ *
+ * The kernels work directly on premultiplied ARGB32 data and are selected
+ * at runtime between AVX2, SSE2 and a scalar fallback. The effect settings
+ * are read from the same configuration entries that KIconEffect uses, so
+ * the results follow the user's icon effect preferences.
+ */
+namespace IconEffects {
+
+enum Effect {
+    NoEffect = 0,
+    ToGray,
+    Colorize,
+    ToGamma,
+    DeSaturate,
+    ToMonochrome
+};
+
+enum InstructionSet {
+    Scalar = 0,
+    Sse2,
+    Avx2
+};
+
+struct Settings {
+    Effect effect{NoEffect};
+    float value{1.0};
+    QColor color;
+    QColor color2;
+    bool semiTransparent{false};
+
+    bool isNull() const {
+        return effect == NoEffect && !semiTransparent;
+    }
+};
+
+/*!
+ * @brief the effect settings of the Desktop group for that state, these are
+ * cached until invalidateSettings() is called
+ */
+Settings settings(KIconLoader::States state);
+void invalidateSettings();
+
+/*!
+ * @brief true if the effect can be applied by Latte's kernels,
+ * ToMonochrome is left to KIconEffect
+ */
+bool isSupported(const Settings &settings);
+
+/*!
+ * @brief apply the effect in place, the image is converted to
+ * premultiplied ARGB32 when needed. Returns false for unsupported effects.
+ */
+bool apply(QImage &image, const Settings &settings);
+
+/*!
+ * @brief apply the effects of that state to the pixmap, falls back to
+ * KIconEffect for the effects that are not supported
+ */
+QPixmap apply(const QPixmap &pixmap, KIconLoader::States state);
+
+void toGray(QImage &image, float value);
+void colorize(QImage &image, const QColor &color, float value);
+void toGamma(QImage &image, float value);
+void deSaturate(QImage &image, float value);
+void semiTransparent(QImage &image);
+
+/*!
+ * @brief the shadow of the image, its alpha blurred and tinted with color.
+ * The result is larger by radius pixels on each side, the blur approximates
+ * the gaussian that QtGraphicalEffects DropShadow uses for that radius
+ */
+QImage shadow(const QImage &image, int radius, const QColor &color);
+
+/*!
+ * @brief the instruction set used by the kernels, it can be forced to
+ * a lower one e.g. for benchmarking. Returns false if it is not supported
+ */
+InstructionSet instructionSet();
+bool setInstructionSet(InstructionSet isa);
+
+}
+
+}
+
+#endif // ICONEFFECTS_H
@@ -0,0 +1,150 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//! this file is compiled with -mavx2, its functions must be called only
+//! after checking that the running cpu supports AVX2
+
+#include "../app/config-latte.h"
+#include "iconeffects_p.h"
+
+#include <immintrin.h>
+
+namespace Latte {
+namespace IconEffects {
+namespace Private {
+
+namespace {
+//! one pixel for each 128bit lane, eight pixels for each block
+struct Avx2Traits {
+    using F = __m256;
+    static const int PixelsPerBlock = 8;
+
+    static inline F zero() { return _mm256_setzero_ps(); }
+    static inline F splat(float v) { return _mm256_set1_ps(v); }
+    static inline F set(float b, float g, float r, float a) { return _mm256_setr_ps(b, g, r, a, b, g, r, a); }
+    static inline F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static inline F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static inline F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static inline F min(F a, F b) { return _mm256_min_ps(a, b); }
+    static inline F max(F a, F b) { return _mm256_max_ps(a, b); }
+    static inline F lessThan(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline F select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+    static inline F swapPairs(F v) { return _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+    static inline F swapHalves(F v) { return _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+    static inline F alpha(F v) { return _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+    static inline F colorMask() { return _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, -1, 0, -1, -1, -1, 0)); }
+
+    //! the unpack/pack instructions work per 128bit lane, px[0] holds
+    //! the pixels 0 and 4, px[1] the pixels 1 and 5 etc.
+    static inline void load(const quint32 *data, F px[4]) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+        const __m256i lo = _mm256_unpacklo_epi8(in, zero);
+        const __m256i hi = _mm256_unpackhi_epi8(in, zero);
+        px[0] = _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(lo, zero));
+        px[1] = _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(lo, zero));
+        px[2] = _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(hi, zero));
+        px[3] = _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(hi, zero));
+    }
+
+    static inline void store(quint32 *data, const F px[4]) {
+        const __m256i lo = _mm256_packs_epi32(_mm256_cvtps_epi32(px[0]), _mm256_cvtps_epi32(px[1]));
+        const __m256i hi = _mm256_packs_epi32(_mm256_cvtps_epi32(px[2]), _mm256_cvtps_epi32(px[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), _mm256_packus_epi16(lo, hi));
+    }
+};
+
+//! unpremultiplies, looks up the gamma table with gathers and premultiplies back.
+//! the scalar kernel rounds with integers, (c * 255 + a / 2) / a and
+//! (g * a + 127) / 255, the same numerators are divided here and truncated.
+//! the quotients are below 256, so the float division never crosses an integer
+inline __m256 toGammaAvx2(__m256 px, const KernelParams &params)
+{
+    const __m256 a = Avx2Traits::alpha(px);
+    const __m256 safeA = _mm256_max_ps(a, _mm256_set1_ps(1.0f));
+    const __m256 halfA = _mm256_floor_ps(_mm256_mul_ps(a, _mm256_set1_ps(0.5f)));
+
+    __m256 unpremultiplied = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(px, _mm256_set1_ps(255.0f)), halfA), safeA);
+    unpremultiplied = _mm256_min_ps(unpremultiplied, _mm256_set1_ps(255.0f));
+
+    const __m256i index = _mm256_cvttps_epi32(unpremultiplied);
+    const __m256 corrected = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(params.gammaTable, index, 4));
+    const __m256 premultiplied = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(corrected, a), _mm256_set1_ps(127.0f))
+                                               , _mm256_set1_ps(255.0f));
+    const __m256 result = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(premultiplied));
+
+    //! the fully transparent pixels are left untouched like in the scalar kernel
+    const __m256 transparent = _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_EQ_OQ);
+
+    return Avx2Traits::select(Avx2Traits::colorMask(), Avx2Traits::select(transparent, px, result), px);
+}
+
+void runToGammaAvx2(quint32 *data, int count, const KernelParams &params)
+{
+    const int vectorCount = count - count % Avx2Traits::PixelsPerBlock;
+    __m256 px[4];
+
+    for (int i = 0; i < vectorCount; i += Avx2Traits::PixelsPerBlock) {
+        Avx2Traits::load(data + i, px);
+
+        for (int j = 0; j < 4; ++j) {
+            px[j] = toGammaAvx2(px[j], params);
+        }
+
+        Avx2Traits::store(data + i, px);
+    }
+
+    runScalar(ToGammaKernel, data + vectorCount, count - vectorCount, params);
+}
+
+void runSemiTransparentAvx2(quint32 *data, int count)
+{
+    const int vectorCount = count - count % Avx2Traits::PixelsPerBlock;
+    const __m256i mask = _mm256_set1_epi32(0x7f7f7f7f);
+
+    for (int i = 0; i < vectorCount; i += Avx2Traits::PixelsPerBlock) {
+        __m256i *p = reinterpret_cast<__m256i *>(data + i);
+        _mm256_storeu_si256(p, _mm256_and_si256(_mm256_srli_epi32(_mm256_loadu_si256(p), 1), mask));
+    }
+
+    runScalar(SemiTransparentKernel, data + vectorCount, count - vectorCount, KernelParams());
+}
+}
+
+void runAvx2(Kernel kernel, quint32 *data, int count, const KernelParams &params)
+{
+    switch (kernel) {
+        case ToGammaKernel:
+            runToGammaAvx2(data, count, params);
+            break;
+
+        case SemiTransparentKernel:
+            runSemiTransparentAvx2(data, count);
+            break;
+
+        default:
+            VectorKernels<Avx2Traits>::run(kernel, data, count, params);
+            break;
+    }
+}
+
+}
+}
+}
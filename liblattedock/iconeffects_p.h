@@ -0,0 +1,172 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ICONEFFECTS_P_H
+#define ICONEFFECTS_P_H
+
+#include <QtGlobal>
+
+//! private part of IconEffects, shared between the scalar/SSE2 translation
+//! unit and the AVX2 one which is compiled with different compiler flags
+
+namespace Latte {
+namespace IconEffects {
+namespace Private {
+
+enum Kernel {
+    ToGrayKernel = 0,
+    ColorizeKernel,
+    ToGammaKernel,
+    DeSaturateKernel,
+    SemiTransparentKernel
+};
+
+//! all values are in the BGRA order of the ARGB32 pixels in memory
+struct KernelParams {
+    float value{1.0};
+    float colorLo[4]{0, 0, 0, 0};
+    float colorHi[4]{0, 0, 0, 0};
+    float colorAdd[4]{0, 0, 0, 0};
+    //! int entries in order to be usable by gather instructions
+    int gammaTable[256];
+};
+
+//! the qGray() weights
+const float GrayB = 5.0f / 32.0f;
+const float GrayG = 16.0f / 32.0f;
+const float GrayR = 11.0f / 32.0f;
+
+//! implemented in iconeffects.cpp, it is also used for the unaligned tails
+//! of the vector kernels. It must not be inlined in the AVX2 translation
+//! unit, otherwise the linker could pick an AVX2 copy for the generic code
+void runScalar(Kernel kernel, quint32 *data, int count, const KernelParams &params);
+
+//!BEGIN vector kernels
+//! V is a small traits class wrapping the intrinsics of an instruction set.
+//! Every pixel is expanded to four float lanes (BGRA) and V::F holds one
+//! pixel per 128bit lane, so all the horizontal operations are in-lane shuffles
+template<class V>
+struct VectorKernels {
+    using F = typename V::F;
+
+    static inline F gray(F px) {
+        F p = V::mul(px, V::set(GrayB, GrayG, GrayR, 0));
+        p = V::add(p, V::swapPairs(p));
+        return V::add(p, V::swapHalves(p));
+    }
+
+    static inline F maxChannel(F px) {
+        F p = V::select(V::colorMask(), px, V::zero());
+        p = V::max(p, V::swapPairs(p));
+        return V::max(p, V::swapHalves(p));
+    }
+
+    static inline F mix(F px, F target, F value) {
+        return V::select(V::colorMask(), V::add(px, V::mul(V::sub(target, px), value)), px);
+    }
+
+    static inline F toGray(F px, const KernelParams &params) {
+        return mix(px, gray(px), V::splat(params.value));
+    }
+
+    static inline F deSaturate(F px, const KernelParams &params) {
+        return mix(px, maxChannel(px), V::splat(params.value));
+    }
+
+    static inline F colorize(F px, const KernelParams &params) {
+        const F g = gray(px);
+        const F a = V::alpha(px);
+        const F threshold = V::mul(a, V::splat(128.0f / 255.0f));
+        const F lo = V::mul(g, V::set(params.colorLo[0], params.colorLo[1], params.colorLo[2], 0));
+        const F hi = V::add(V::mul(V::sub(g, threshold), V::set(params.colorHi[0], params.colorHi[1], params.colorHi[2], 0)),
+                            V::mul(a, V::set(params.colorAdd[0], params.colorAdd[1], params.colorAdd[2], 0)));
+        F c = V::select(V::lessThan(g, threshold), lo, hi);
+        c = V::min(V::max(c, V::zero()), a);
+
+        return mix(px, c, V::splat(params.value));
+    }
+
+    static inline F apply(Kernel kernel, F px, const KernelParams &params) {
+        switch (kernel) {
+            case ToGrayKernel:
+                return toGray(px, params);
+
+            case ColorizeKernel:
+                return colorize(px, params);
+
+            case DeSaturateKernel:
+                return deSaturate(px, params);
+
+            default:
+                return px;
+        }
+    }
+
+    //! the kernel switch is hoisted out of the pixel loop
+    template<Kernel K>
+    static void run(quint32 *data, int count, const KernelParams &params) {
+        const int vectorCount = count - count % V::PixelsPerBlock;
+        F px[4];
+
+        for (int i = 0; i < vectorCount; i += V::PixelsPerBlock) {
+            V::load(data + i, px);
+
+            for (int j = 0; j < 4; ++j) {
+                px[j] = apply(K, px[j], params);
+            }
+
+            V::store(data + i, px);
+        }
+
+        runScalar(K, data + vectorCount, count - vectorCount, params);
+    }
+
+    static void run(Kernel kernel, quint32 *data, int count, const KernelParams &params) {
+        switch (kernel) {
+            case ToGrayKernel:
+                run<ToGrayKernel>(data, count, params);
+                break;
+
+            case ColorizeKernel:
+                run<ColorizeKernel>(data, count, params);
+                break;
+
+            case DeSaturateKernel:
+                run<DeSaturateKernel>(data, count, params);
+                break;
+
+            default:
+                runScalar(kernel, data, count, params);
+                break;
+        }
+    }
+};
+//!END vector kernels
+
+#if HAVE_AVX2
+//! implemented in iconeffects_avx2.cpp
+void runAvx2(Kernel kernel, quint32 *data, int count, const KernelParams &params);
+#endif
+
+}
+}
+}
+
+#endif // ICONEFFECTS_P_H
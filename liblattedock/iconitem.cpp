@@ -21,37 +21,76 @@
 */
 
 #include "iconitem.h"
+#include "iconcache.h"
+#include "iconcolors.h"
+#include "iconeffects.h"
 #include "../liblattedock/extras.h"
 
+#include <QCache>
 #include <QDebug>
 #include <QPainter>
 #include <QPaintEngine>
 #include <QQuickWindow>
 #include <QPixmap>
 #include <QSGSimpleTextureNode>
+#include <QtMath>
 #include <QuickAddons/ManagedTextureNode>
 
 #include <KIconTheme>
 #include <KIconThemes/KIconLoader>
-#include <KIconThemes/KIconEffect>
+
+#include <Plasma/Theme>
 
 namespace Latte {
 
+//! shadows shared between all the items, the cost is in KB
+static QCache<QString, QImage> s_shadowCache(8 * 1024);
+
+//! the caches that all the items share are cleared once for each change
+//! of the icon settings, before the items refresh their own state
+static void connectSharedCaches()
+{
+    static bool connected{false};
+
+    if (connected) {
+        return;
+    }
+
+    connected = true;
+    QObject::connect(KIconLoader::global(), &KIconLoader::iconLoaderSettingsChanged, IconColors::self(), []() {
+        IconEffects::invalidateSettings();
+        s_shadowCache.clear();
+        IconColors::self()->clear();
+        IconCache::clear();
+    });
+}
+
 IconItem::IconItem(QQuickItem *parent)
     : QQuickItem(parent),
       m_lastValidSourceName(QString()),
       m_smooth(false),
       m_active(false),
       m_textureChanged(false),
-      m_sizeChanged(false)
+      m_sizeChanged(false),
+      m_basePixmapChanged(true)
 {
     setFlag(ItemHasContents, true);
+    connectSharedCaches();
+    connect(KIconLoader::global(), &KIconLoader::iconLoaderSettingsChanged, this, [&]() {
+        m_statePixmaps.clear();
+        m_shadowKey.clear();
+        m_colorsKey.clear();
+        m_diskCacheChecked = false;
+        schedulePixmapUpdate();
+    });
     connect(KIconLoader::global(), SIGNAL(iconLoaderSettingsChanged()),
             this, SIGNAL(implicitWidthChanged()));
     connect(KIconLoader::global(), SIGNAL(iconLoaderSettingsChanged()),
             this, SIGNAL(implicitHeightChanged()));
     connect(this, &QQuickItem::enabledChanged,
             this, &IconItem::enabledChanged);
+    connect(IconColors::self(), &IconColors::colorsReady,
+            this, &IconItem::iconColorsReady);
     connect(this, &QQuickItem::windowChanged,
             this, &IconItem::schedulePixmapUpdate);
     connect(this, SIGNAL(overlaysChanged()),
@@ -159,6 +198,9 @@ void IconItem::setSource(const QVariant &source)
         m_svgIcon.reset();
     }
 
+    m_colorsKey.clear();
+    m_diskCacheChecked = false;
+
     if (width() > 0 && height() > 0) {
         schedulePixmapUpdate();
     }
@@ -218,7 +260,7 @@ void IconItem::setActive(bool active)
     m_active = active;
 
     if (isComponentComplete()) {
-        schedulePixmapUpdate();
+        polish();
     }
 
     emit activeChanged();
@@ -244,6 +286,65 @@ bool IconItem::isValid() const
     return !m_icon.isNull() || m_svgIcon || !m_imageIcon.isNull();
 }
 
+int IconItem::shadowSize() const
+{
+    return m_shadowSize;
+}
+
+void IconItem::setShadowSize(int size)
+{
+    if (m_shadowSize == size) {
+        return;
+    }
+
+    m_shadowSize = size;
+    polish();
+    emit shadowSizeChanged();
+}
+
+QColor IconItem::shadowColor() const
+{
+    return m_shadowColor;
+}
+
+void IconItem::setShadowColor(const QColor &color)
+{
+    if (m_shadowColor == color) {
+        return;
+    }
+
+    m_shadowColor = color;
+    polish();
+    emit shadowColorChanged();
+}
+
+int IconItem::shadowVerticalOffset() const
+{
+    return m_shadowVerticalOffset;
+}
+
+void IconItem::setShadowVerticalOffset(int offset)
+{
+    if (m_shadowVerticalOffset == offset) {
+        return;
+    }
+
+    m_shadowVerticalOffset = offset;
+    m_sizeChanged = true;
+    update();
+    emit shadowVerticalOffsetChanged();
+}
+
+QColor IconItem::averageColor() const
+{
+    return m_averageColor;
+}
+
+QColor IconItem::dominantColor() const
+{
+    return m_dominantColor;
+}
+
 int IconItem::paintedWidth() const
 {
     return boundingRect().size().toSize().width();
@@ -257,7 +358,12 @@ int IconItem::paintedHeight() const
 void IconItem::updatePolish()
 {
     QQuickItem::updatePolish();
-    loadPixmap();
+
+    if (m_basePixmapChanged) {
+        loadPixmap();
+    } else {
+        updateStatePixmap();
+    }
 }
 
 QSGNode *IconItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *updatePaintNodeData)
@@ -269,36 +375,130 @@ QSGNode *IconItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *update
         return nullptr;
     }
 
-    ManagedTextureNode *textureNode = dynamic_cast<ManagedTextureNode *>(oldNode);
+    //! the root node has the icon as its last child and the shadow,
+    //! when there is one, as its first child in order to be drawn under it
+    QSGNode *root = oldNode;
+
+    if (!root) {
+        root = new QSGNode;
+        m_textureChanged = true;
+        m_shadowChanged = true;
+    }
+
+    ManagedTextureNode *textureNode = static_cast<ManagedTextureNode *>(root->lastChild());
+    ManagedTextureNode *shadowNode = root->childCount() > 1 ? static_cast<ManagedTextureNode *>(root->firstChild()) : nullptr;
 
     if (!textureNode || m_textureChanged) {
-        if (oldNode)
-            delete oldNode;
+        if (textureNode) {
+            root->removeChildNode(textureNode);
+            delete textureNode;
+        }
 
         textureNode = new ManagedTextureNode;
         textureNode->setTexture(QSharedPointer<QSGTexture>(window()->createTextureFromImage(m_iconPixmap.toImage())));
+        root->appendChildNode(textureNode);
         m_sizeChanged = true;
         m_textureChanged = false;
     }
 
+    if (m_shadowChanged) {
+        if (shadowNode) {
+            root->removeChildNode(shadowNode);
+            delete shadowNode;
+            shadowNode = nullptr;
+        }
+
+        if (!m_shadowImage.isNull()) {
+            shadowNode = new ManagedTextureNode;
+            shadowNode->setTexture(QSharedPointer<QSGTexture>(window()->createTextureFromImage(m_shadowImage)));
+            root->prependChildNode(shadowNode);
+        }
+
+        m_sizeChanged = true;
+        m_shadowChanged = false;
+    }
+
     if (m_sizeChanged) {
         const auto iconSize = qMin(boundingRect().size().width(), boundingRect().size().height());
         const QRectF destRect(QPointF(boundingRect().center() - QPointF(iconSize / 2, iconSize / 2)), QSizeF(iconSize, iconSize));
         textureNode->setRect(destRect);
+
+        if (shadowNode) {
+            //! the padding is in pixmap pixels
+            const qreal paddingX = m_shadowPadding * destRect.width() / m_iconPixmap.width();
+            const qreal paddingY = m_shadowPadding * destRect.height() / m_iconPixmap.height();
+            shadowNode->setRect(destRect.adjusted(-paddingX, -paddingY, paddingX, paddingY)
+                                .translated(0, m_shadowVerticalOffset));
+        }
+
         m_sizeChanged = false;
     }
 
-    return textureNode;
+    return root;
 }
 
 void IconItem::schedulePixmapUpdate()
 {
+    m_basePixmapChanged = true;
     polish();
 }
 
 void IconItem::enabledChanged()
 {
-    schedulePixmapUpdate();
+    //! only the state effect changes, the base pixmap is reused
+    polish();
+}
+
+void IconItem::iconColorsReady(const QString &key)
+{
+    if (key != m_colorsKey) {
+        return;
+    }
+
+    const IconColors::Colors colors = IconColors::self()->colors(key);
+
+    if (colors.average == m_averageColor && colors.dominant == m_dominantColor) {
+        return;
+    }
+
+    m_averageColor = colors.average;
+    m_dominantColor = colors.dominant;
+    emit colorsChanged();
+}
+
+QPixmap IconItem::renderSvg(qreal size)
+{
+    QPixmap result;
+    m_svgIcon->resize(size, size);
+
+    if (m_svgIcon->hasElement(m_svgIconName)) {
+        result = m_svgIcon->pixmap(m_svgIconName);
+    } else if (!m_svgIconName.isEmpty()) {
+        const auto *iconTheme = KIconLoader::global()->theme();
+        QString iconPath;
+
+        if (iconTheme) {
+            iconPath = iconTheme->iconPath(m_svgIconName + QLatin1String(".svg")
+                                           , static_cast<int>(qMin(width(), height()))
+                                           , KIconLoader::MatchBest);
+
+            if (iconPath.isEmpty()) {
+                iconPath = iconTheme->iconPath(m_svgIconName + QLatin1String(".svgz"),
+                                               static_cast<int>(qMin(width(), height()))
+                                               , KIconLoader::MatchBest);
+            }
+        } else {
+            qWarning() << "KIconLoader has no theme set";
+        }
+
+        if (!iconPath.isEmpty()) {
+            m_svgIcon->setImagePath(iconPath);
+        }
+
+        result = m_svgIcon->pixmap();
+    }
+
+    return result;
 }
 
 void IconItem::loadPixmap()
@@ -311,45 +511,38 @@ void IconItem::loadPixmap()
     //final pixmap to paint
     QPixmap result;
 
+    m_basePixmapChanged = false;
+    m_statePixmaps.clear();
+
     if (size <= 0) {
+        m_basePixmap = QPixmap();
         m_iconPixmap = QPixmap();
         update();
         return;
-    } else if (m_svgIcon) {
-        m_svgIcon->resize(size, size);
-
-        if (m_svgIcon->hasElement(m_svgIconName)) {
-            result = m_svgIcon->pixmap(m_svgIconName);
-        } else if (!m_svgIconName.isEmpty()) {
-            const auto *iconTheme = KIconLoader::global()->theme();
-            QString iconPath;
-
-            if (iconTheme) {
-                iconPath = iconTheme->iconPath(m_svgIconName + QLatin1String(".svg")
-                                               , static_cast<int>(qMin(width(), height()))
-                                               , KIconLoader::MatchBest);
-
-                if (iconPath.isEmpty()) {
-                    iconPath = iconTheme->iconPath(m_svgIconName + QLatin1String(".svgz"),
-                                                   static_cast<int>(qMin(width(), height()))
-                                                   , KIconLoader::MatchBest);
-                }
-            } else {
-                qWarning() << "KIconLoader has no theme set";
-            }
-
-            if (!iconPath.isEmpty()) {
-                m_svgIcon->setImagePath(iconPath);
-            }
-
-            result = m_svgIcon->pixmap();
+    } else if (m_svgIcon && !m_diskCacheChecked) {
+        //! the first pixmap of each source comes from the disk cache, so it
+        //! does not need to parse and render the svg file. The next sizes,
+        //! e.g. during zoom, are rendered as usual and they are not stored
+        m_diskCacheChecked = true;
+        const qreal dpr = window() ? window()->devicePixelRatio() : qApp->devicePixelRatio();
+        const QString cacheKey = IconCache::key(m_svgIcon->imagePath(), m_svgIconName, static_cast<int>(size), dpr, KIconLoader::DefaultState);
+        const QImage cached = IconCache::load(cacheKey);
+
+        if (!cached.isNull()) {
+            result = QPixmap::fromImage(cached);
+        } else {
+            result = renderSvg(size);
+            IconCache::store(cacheKey, result.toImage());
         }
+    } else if (m_svgIcon) {
+        result = renderSvg(size);
     } else if (!m_icon.isNull()) {
         result = m_icon.pixmap(QSize(static_cast<int>(size), static_cast<int>(size))
                                * (window() ? window()->devicePixelRatio() : qApp->devicePixelRatio()));
     } else if (!m_imageIcon.isNull()) {
         result = QPixmap::fromImage(m_imageIcon);
     } else {
+        m_basePixmap = QPixmap();
         m_iconPixmap = QPixmap();
         update();
         return;
@@ -369,18 +562,117 @@ void IconItem::loadPixmap()
         }
     }
 
+    m_basePixmap = result;
+    updateColors();
+    updateStatePixmap();
+}
+
+QString IconItem::iconKey(const QPixmap &pixmap) const
+{
+    //! theme icons have the same pixmap in every item, svg icons follow
+    //! the plasma theme colors and they are identified by their element
+    if (m_svgIcon && !m_svgIconName.isEmpty()) {
+        return QStringLiteral("%1_%2:%3_%4x%5").arg(m_svgIcon->theme()->themeName()).arg(m_svgIcon->imagePath())
+               .arg(m_svgIconName).arg(pixmap.width()).arg(pixmap.height());
+    }
+
+    const QString name = m_svgIcon ? QString() : m_icon.name();
+
+    if (name.isEmpty()) {
+        return IconColors::PixmapKeyPrefix + QString::number(pixmap.cacheKey());
+    }
+
+    return name + QLatin1Char('_') + m_overlays.join(QLatin1Char(','));
+}
+
+void IconItem::updateColors()
+{
+    //! the colors are computed only once for each source, zooming reloads
+    //! the pixmap but the colors stay the same
+    if (!m_colorsKey.isEmpty() || m_basePixmap.isNull()) {
+        return;
+    }
+
+    m_colorsKey = iconKey(m_basePixmap);
+    IconColors::self()->request(m_colorsKey, m_basePixmap.toImage());
+    //! it is already cached or it was computed for another item
+    iconColorsReady(m_colorsKey);
+}
+
+void IconItem::updateStatePixmap()
+{
+    if (m_basePixmap.isNull()) {
+        updateShadow();
+        return;
+    }
+
+    KIconLoader::States state = KIconLoader::DefaultState;
+
     if (!isEnabled()) {
-        result = KIconLoader::global()->iconEffect()->apply(result, KIconLoader::Desktop, KIconLoader::DisabledState);
+        state = KIconLoader::DisabledState;
     } else if (m_active) {
-        result = KIconLoader::global()->iconEffect()->apply(result, KIconLoader::Desktop, KIconLoader::ActiveState);
+        state = KIconLoader::ActiveState;
+    }
+
+    QPixmap result;
+
+    if (state == KIconLoader::DefaultState) {
+        result = m_basePixmap;
+    } else if (m_statePixmaps.contains(state)) {
+        result = m_statePixmaps.value(state);
+    } else {
+        result = IconEffects::apply(m_basePixmap, state);
+        m_statePixmaps[state] = result;
+    }
+
+    if (result.cacheKey() != m_iconPixmap.cacheKey()) {
+        m_iconPixmap = result;
+        m_textureChanged = true;
     }
 
-    m_iconPixmap = result;
-    m_textureChanged = true;
+    updateShadow();
     //don't animate initial setting
     update();
 }
 
+void IconItem::updateShadow()
+{
+    const auto size = qMin(width(), height());
+
+    if (m_shadowSize <= 0 || m_iconPixmap.isNull() || size <= 0) {
+        if (!m_shadowImage.isNull()) {
+            m_shadowImage = QImage();
+            m_shadowKey.clear();
+            m_shadowChanged = true;
+        }
+
+        return;
+    }
+
+    const int padding = qCeil(m_shadowSize * m_iconPixmap.width() / size);
+
+    const int state = !isEnabled() ? KIconLoader::DisabledState
+                      : (m_active ? KIconLoader::ActiveState : KIconLoader::DefaultState);
+    const QString key = QStringLiteral("%1_%2_%3x%4_%5_%6").arg(iconKey(m_iconPixmap)).arg(state)
+                        .arg(m_iconPixmap.width()).arg(m_iconPixmap.height())
+                        .arg(padding).arg(m_shadowColor.rgba());
+
+    if (key == m_shadowKey) {
+        return;
+    }
+
+    if (QImage *cached = s_shadowCache.object(key)) {
+        m_shadowImage = *cached;
+    } else {
+        m_shadowImage = IconEffects::shadow(m_iconPixmap.toImage(), padding, m_shadowColor);
+        s_shadowCache.insert(key, new QImage(m_shadowImage), qMax(1, m_shadowImage.byteCount() / 1024));
+    }
+
+    m_shadowKey = key;
+    m_shadowPadding = padding;
+    m_shadowChanged = true;
+}
+
 void IconItem::itemChange(ItemChange change, const ItemChangeData &value)
 {
     QQuickItem::itemChange(change, value);
@@ -26,12 +26,16 @@
 #include <memory>
 
 #include <QQuickItem>
+#include <QColor>
+#include <QHash>
 #include <QIcon>
 #include <QImage>
 #include <QPixmap>
 
 #include <Plasma/Svg>
 
+#include <KIconThemes/KIconLoader>
+
 // this file is based on PlasmaCore::IconItem class, thanks to KDE
 namespace Latte {
 class IconItem : public QQuickItem {
@@ -83,6 +87,29 @@ class IconItem : public QQuickItem {
      */
     Q_PROPERTY(int paintedHeight READ paintedHeight NOTIFY paintedSizeChanged)
 
+    /**
+     * The radius of the icon shadow, 0 disables it. The shadow is computed
+     * once for each icon, size and color and it is drawn under the icon,
+     * outside of the item bounds
+     */
+    Q_PROPERTY(int shadowSize READ shadowSize WRITE setShadowSize NOTIFY shadowSizeChanged)
+
+    Q_PROPERTY(QColor shadowColor READ shadowColor WRITE setShadowColor NOTIFY shadowColorChanged)
+
+    Q_PROPERTY(int shadowVerticalOffset READ shadowVerticalOffset WRITE setShadowVerticalOffset NOTIFY shadowVerticalOffsetChanged)
+
+    /**
+     * The alpha weighted average color of the icon
+     */
+    Q_PROPERTY(QColor averageColor READ averageColor NOTIFY colorsChanged)
+
+    /**
+     * The most frequent color of the icon, colorful colors are preferred.
+     * Both colors are computed once for each icon in a worker thread and
+     * they are invalid until then
+     */
+    Q_PROPERTY(QColor dominantColor READ dominantColor NOTIFY colorsChanged)
+
     /**
      * Contains the last valid icon name
      */
@@ -106,6 +133,18 @@ public:
 
     bool isValid() const;
 
+    int shadowSize() const;
+    void setShadowSize(int size);
+
+    QColor shadowColor() const;
+    void setShadowColor(const QColor &color);
+
+    int shadowVerticalOffset() const;
+    void setShadowVerticalOffset(int offset);
+
+    QColor averageColor() const;
+    QColor dominantColor() const;
+
     int paintedWidth() const;
     int paintedHeight() const;
 
@@ -127,17 +166,42 @@ signals:
     void smoothChanged();
     void validChanged();
     void paintedSizeChanged();
+    void shadowSizeChanged();
+    void shadowColorChanged();
+    void shadowVerticalOffsetChanged();
+    void colorsChanged();
 
 private slots:
     void schedulePixmapUpdate();
     void enabledChanged();
+    void iconColorsReady(const QString &key);
 
 private:
     void loadPixmap();
+    QPixmap renderSvg(qreal size);
+    void updateStatePixmap();
+    void updateShadow();
+    void updateColors();
+    //! an id of the icon, shared by the items that show the same theme icon
+    QString iconKey(const QPixmap &pixmap) const;
     void setLastValidSourceName(QString name);
 
     QIcon m_icon;
+    //! the pixmap that is painted, m_basePixmap with the state effect applied
     QPixmap m_iconPixmap;
+    //! the loaded pixmap with its overlays, without any state effect
+    QPixmap m_basePixmap;
+    //! the state pixmaps created from m_basePixmap, so hovering and
+    //! enabling/disabling the icon do not reload it
+    QHash<int, QPixmap> m_statePixmaps;
+    //! the shadow of m_iconPixmap, padded by m_shadowPadding pixels
+    QImage m_shadowImage;
+    QString m_shadowKey;
+    int m_shadowPadding{0};
+    //! the key of the icon colors, empty until they are requested for the current source
+    QString m_colorsKey;
+    QColor m_averageColor;
+    QColor m_dominantColor;
     QImage m_imageIcon;
     std::unique_ptr<Plasma::Svg> m_svgIcon;
     QString m_lastValidSourceName;
@@ -151,8 +215,16 @@ private:
     bool m_smooth;
     bool m_active;
 
+    int m_shadowSize{0};
+    int m_shadowVerticalOffset{2};
+    QColor m_shadowColor{QColor(8, 8, 8)};
+
     bool m_textureChanged;
     bool m_sizeChanged;
+    bool m_basePixmapChanged;
+    bool m_shadowChanged{false};
+    //! the disk cache is used only for the first pixmap of each source
+    bool m_diskCacheChecked{false};
 };
 
 }
@@ -22,13 +22,18 @@
 #include "quickwindowsystem.h"
 #include "dock.h"
 #include "iconitem.h"
+#include "startuptrace.h"
+#include "taskmanagerendpoint.h"
 
 #include <QtQml>
 
 void LatteDockPlugin::registerTypes(const char *uri)
 {
+    LATTE_TRACE_SCOPE("LatteDockPlugin::registerTypes");
+
     Q_ASSERT(uri == QLatin1String("org.kde.latte"));
     qmlRegisterUncreatableType<Latte::Dock>(uri, 0, 1, "Dock", "Latte Dock Types uncreatable");
     qmlRegisterType<Latte::IconItem>(uri, 0, 1, "IconItem");
+    qmlRegisterType<Latte::TaskManagerEndpoint>(uri, 0, 1, "TaskManagerEndpoint");
     qmlRegisterSingletonType<Latte::QuickWindowSystem>(uri, 0, 1, "WindowSystem", &Latte::windowsystem_qobject_singletontype_provider);
 }
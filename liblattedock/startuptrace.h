@@ -0,0 +1,143 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QCoreApplication>
+#include <QString>
+#include <QVariant>
+
+//! this header is shared between latte-dock which records the startup trace
+//! and the lattedock plugin which adds its spans to it, it must stay header only
+
+namespace Latte {
+
+namespace StartupTrace {
+
+//! the name of the qApp property that holds the recorder, it is set only
+//! when latte-dock was started with --trace-startup
+const char RecorderProperty[] = "_latte_startupTraceRecorder";
+
+/**
+ * @brief The Recorder class, collects the spans of the startup. It is
+ * implemented by latte-dock, the methods must be thread safe.
+ */
+class Recorder {
+public:
+    virtual ~Recorder() {}
+
+    //! microseconds since the start of latte-dock
+    virtual qint64 now() const = 0;
+    virtual void complete(const char *name, const char *category, qint64 begin, qint64 end, const QString &detail) = 0;
+    virtual void instant(const char *name, const char *category, const QString &detail) = 0;
+};
+
+//! the recorder or nullptr when tracing is disabled, it is looked up once
+//! by each binary so a disabled trace costs a single check
+inline Recorder *recorder()
+{
+    static Recorder *const s_recorder = []() -> Recorder * {
+        const QCoreApplication *app = QCoreApplication::instance();
+        return app ? reinterpret_cast<Recorder *>(app->property(RecorderProperty).value<quintptr>()) : nullptr;
+    }();
+
+    return s_recorder;
+}
+
+inline qint64 now()
+{
+    Recorder *r = recorder();
+    return r ? r->now() : 0;
+}
+
+inline void complete(const char *name, qint64 begin, const char *category = "latte", const QString &detail = QString())
+{
+    if (Recorder *r = recorder()) {
+        r->complete(name, category, begin, r->now(), detail);
+    }
+}
+
+inline void instant(const char *name, const char *category = "latte", const QString &detail = QString())
+{
+    if (Recorder *r = recorder()) {
+        r->instant(name, category, detail);
+    }
+}
+
+/**
+ * @brief The Span class, records the time from its construction until its
+ * destruction or finish() as one event of the trace
+ */
+class Span {
+public:
+    explicit Span(const char *name, const char *category = "latte")
+        : m_name(name),
+          m_category(category),
+          m_recorder(recorder())
+    {
+        if (m_recorder) {
+            m_begin = m_recorder->now();
+        }
+    }
+
+    ~Span()
+    {
+        finish();
+    }
+
+    bool isRecording() const {
+        return m_recorder != nullptr;
+    }
+
+    //! shown with the event, it should be set only when isRecording()
+    void setDetail(const QString &detail) {
+        m_detail = detail;
+    }
+
+    void finish() {
+        if (m_recorder) {
+            m_recorder->complete(m_name, m_category, m_begin, m_recorder->now(), m_detail);
+            m_recorder = nullptr;
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(Span)
+
+    const char *m_name;
+    const char *m_category;
+    qint64 m_begin{0};
+    Recorder *m_recorder;
+    QString m_detail;
+};
+
+}
+
+}
+
+#define LATTE_TRACE_CONCAT_(a, b) a##b
+#define LATTE_TRACE_CONCAT(a, b) LATTE_TRACE_CONCAT_(a, b)
+
+//! records the enclosing scope with that name
+#define LATTE_TRACE_SCOPE(name) \
+    Latte::StartupTrace::Span LATTE_TRACE_CONCAT(latteTraceSpan, __LINE__)(name)
+
+#endif // STARTUPTRACE_H
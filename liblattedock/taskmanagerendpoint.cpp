@@ -0,0 +1,75 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "taskmanagerendpoint.h"
+#include "startuptrace.h"
+
+#include <QCoreApplication>
+
+namespace Latte {
+
+TaskManagerEndpoint::TaskManagerEndpoint(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+}
+
+TaskManagerEndpoint::~TaskManagerEndpoint()
+{
+    if (m_registry) {
+        QMetaObject::invokeMethod(m_registry, "unregisterEndpoint", Qt::DirectConnection, Q_ARG(QObject *, this));
+    }
+}
+
+bool TaskManagerEndpoint::registered() const
+{
+    return !m_registry.isNull();
+}
+
+void TaskManagerEndpoint::componentComplete()
+{
+    QQuickItem::componentComplete();
+
+    m_registry = qApp->property(TaskManagerRegistryProperty).value<QObject *>();
+
+    if (m_registry) {
+        QMetaObject::invokeMethod(m_registry, "registerEndpoint", Qt::DirectConnection, Q_ARG(QObject *, this));
+        emit registeredChanged();
+    }
+
+    //! the tasks plasmoid has been created
+    StartupTrace::instant("tasks plasmoid ready");
+}
+
+void TaskManagerEndpoint::activateTaskAtIndex(int index)
+{
+    emit activateTaskAtIndexRequested(index);
+}
+
+void TaskManagerEndpoint::newInstanceForTaskAtIndex(int index)
+{
+    emit newInstanceForTaskAtIndexRequested(index);
+}
+
+void TaskManagerEndpoint::updateItems(const QVariantList &updates)
+{
+    emit updateItemsRequested(updates);
+}
+
+}
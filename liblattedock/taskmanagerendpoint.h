@@ -0,0 +1,69 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TASKMANAGERENDPOINT_H
+#define TASKMANAGERENDPOINT_H
+
+#include "taskmanagerinterface.h"
+
+#include <QPointer>
+#include <QQuickItem>
+
+namespace Latte {
+
+/**
+ * @brief The TaskManagerEndpoint class, a Latte task manager creates one
+ * and it is registered to latte-dock while it exists. The calls of
+ * latte-dock are forwarded to QML through the signals.
+ */
+class TaskManagerEndpoint : public QQuickItem, public TaskManagerInterface {
+    Q_OBJECT
+    Q_INTERFACES(Latte::TaskManagerInterface)
+    //! true in latte-dock, which feeds the badges and progress of the
+    //! LauncherEntry API through updateItems()
+    Q_PROPERTY(bool registered READ registered NOTIFY registeredChanged)
+
+public:
+    explicit TaskManagerEndpoint(QQuickItem *parent = nullptr);
+    ~TaskManagerEndpoint() override;
+
+    bool registered() const;
+
+    void activateTaskAtIndex(int index) override;
+    void newInstanceForTaskAtIndex(int index) override;
+    void updateItems(const QVariantList &updates) override;
+
+signals:
+    void activateTaskAtIndexRequested(int index);
+    void newInstanceForTaskAtIndexRequested(int index);
+    void updateItemsRequested(const QVariantList &updates);
+    void registeredChanged();
+
+protected:
+    void componentComplete() override;
+
+private:
+    //! latte-dock owns the registry, it is not present in plasmashell
+    QPointer<QObject> m_registry;
+};
+
+}
+
+#endif // TASKMANAGERENDPOINT_H
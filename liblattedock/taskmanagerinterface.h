@@ -0,0 +1,55 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TASKMANAGERINTERFACE_H
+#define TASKMANAGERINTERFACE_H
+
+#include <QtPlugin>
+#include <QString>
+#include <QVariantList>
+
+//! this header is shared between the lattedock plugin which implements the
+//! interface and latte-dock which calls it, it must stay header only
+
+namespace Latte {
+
+//! the name of the qApp property that holds the registry of the task managers
+const char TaskManagerRegistryProperty[] = "_latte_taskManagerRegistry";
+
+/**
+ * @brief The TaskManagerInterface class, the calls that latte-dock dispatches
+ * to the Latte task managers for the global shortcuts and the badges.
+ */
+class TaskManagerInterface {
+public:
+    virtual ~TaskManagerInterface() {}
+
+    virtual void activateTaskAtIndex(int index) = 0;
+    virtual void newInstanceForTaskAtIndex(int index) = 0;
+    //! a batch of QVariantMaps with the identifier and any of the badge,
+    //! progress and urgent fields
+    virtual void updateItems(const QVariantList &updates) = 0;
+};
+
+}
+
+Q_DECLARE_INTERFACE(Latte::TaskManagerInterface, "org.kde.latte.TaskManagerInterface/1.1")
+
+#endif // TASKMANAGERINTERFACE_H
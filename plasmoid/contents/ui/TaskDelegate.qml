@@ -78,7 +78,7 @@ MouseArea{
     property bool inPopup: false
 
     property bool isActive: (IsActive === true) ? true : false
-    property bool isDemandingAttention: (IsDemandingAttention === true) ? true : false
+    property bool isDemandingAttention: (IsDemandingAttention === true) || (urgentIndicator && root.smartLaunchersEnabled) ? true : false
     property bool isDragged: false
     property bool isGroupParent: (IsGroupParent === true) ? true : false
     property bool isLauncher: (IsLauncher === true) ? true : false
@@ -89,9 +89,11 @@ MouseArea{
 
     property bool mouseEntered: false
     property bool pressed: false
+    property bool urgentIndicator: false //it is used from external apps
 
     property int animationTime: root.durationTime * 1.2 * units.shortDuration
     property int badgeIndicator: 0 //it is used from external apps
+    property int progressIndicator: -1 //it is used from external apps, -1 hides it
     property int directAnimationTime: 0
     property int hoveredIndex: icList.hoveredIndex
     property int itemIndex: index
@@ -59,6 +59,8 @@ Item{
     property int shadowSize : Math.ceil(root.iconSize / 10)
 
     readonly property bool smartLauncherEnabled: ((mainItemContainer.isStartup === false) && (root.smartLaunchersEnabled))
+    //! only one source feeds the badges and the progress
+    readonly property bool smartLauncherItemNeeded: smartLauncherEnabled && !root.dockProvidesLauncherEntries
     readonly property variant iconDecoration: decoration
     property QtObject buffers: null
     property QtObject smartLauncherItem: null
@@ -70,8 +72,8 @@ Item{
         color: "transparent"
     } */
 
-    onSmartLauncherEnabledChanged: {
-        if (smartLauncherEnabled && !smartLauncherItem) {
+    onSmartLauncherItemNeededChanged: {
+        if (smartLauncherItemNeeded && !smartLauncherItem) {
             var smartLauncher = Qt.createQmlObject(
                         " import org.kde.plasma.private.taskmanager 0.1 as TaskManagerApplet; TaskManagerApplet.SmartLauncherItem { }",
                         centralItem);
@@ -79,7 +81,7 @@ Item{
             smartLauncher.launcherUrl = Qt.binding(function() { return model.LauncherUrlWithoutIcon; });
 
             smartLauncherItem = smartLauncher;
-        } else if (!smartLauncherEnabled && smartLauncherItem) {
+        } else if (!smartLauncherItemNeeded && smartLauncherItem) {
             smartLauncherItem.destroy();
             smartLauncherItem = null;
         }
@@ -142,6 +144,12 @@ Item{
             //icon: decoration
             source: decoration
 
+            //the shadow is drawn by the item itself, it is computed once for each icon and size.
+            //With the progress overlay taskWithShadow draws it around the whole graphic
+            shadowSize: root.enableShadows && !progressLoader.active ? centralItem.shadowSize : 0
+            shadowColor: "#ff080808"
+            shadowVerticalOffset: 2
+
             //visible: !root.enableShadows
 
             onValidChanged: {
@@ -225,8 +233,9 @@ Item{
         Loader{
             id: progressLoader
             anchors.fill: parent
-            active: (centralItem.smartLauncherEnabled && centralItem.smartLauncherItem
-                     && (centralItem.smartLauncherItem.progressVisible || mainItemContainer.badgeIndicator > 0))
+            active: centralItem.smartLauncherEnabled
+                    && ((centralItem.smartLauncherItem && centralItem.smartLauncherItem.progressVisible)
+                        || mainItemContainer.badgeIndicator > 0 || mainItemContainer.progressIndicator >= 0)
             asynchronous: true
 
             sourceComponent: Item{
@@ -326,11 +335,11 @@ Item{
         //}
     }
 
-    ///Shadow in tasks
+    ///Shadow in tasks, only when the progress overlay hides the icon
     Loader{
         id: taskWithShadow
         anchors.fill: iconGraphic
-        active: root.enableShadows
+        active: root.enableShadows && progressLoader.active && !root.dockResourcesReleased
 
         sourceComponent: DropShadow{
             anchors.fill: parent
@@ -623,7 +632,7 @@ Item{
         id:newWindowAnimation
 
         property int speed: root.durationTime*units.longDuration
-        property bool isDemandingAttention: (IsDemandingAttention === true)
+        property bool isDemandingAttention: (IsDemandingAttention === true) || (mainItemContainer.urgentIndicator && root.smartLaunchersEnabled)
         property bool entered: mainItemContainer.mouseEntered
         property bool needsThicknessSent: false //flag to check if the signal for thickness was sent
 
@@ -771,24 +780,12 @@ Item{
 
                     width: iconImageBuffer.width
                     height: width
-                    visible: root.enableShadows ? false : true
 
                     source: iconImageBuffer.lastValidSourceName
-                }
 
-                Loader{
-                    id: tempTaskShadow
-                    anchors.fill: tempRemoveIcon
-                    active: root.enableShadows
-
-                    sourceComponent: DropShadow{
-                        anchors.fill: parent
-                        color: "#ff080808"
-                        samples: 2 * radius
-                        source: tempRemoveIcon
-                        radius: centralItem.shadowSize
-                        verticalOffset: 2
-                    }
+                    shadowSize: root.enableShadows ? centralItem.shadowSize : 0
+                    shadowColor: "#ff080808"
+                    shadowVerticalOffset: 2
                 }
 
                 Colorize{
@@ -56,7 +56,13 @@ Item {
             anchors.centerIn: parent
             width: 0.8 * parent.width
             height: width
-            numberValue: mainItemContainer.badgeIndicator > 0 ? mainItemContainer.badgeIndicator : centralItem.smartLauncherItem.count
+            numberValue: {
+                if (mainItemContainer.badgeIndicator > 0) {
+                    return mainItemContainer.badgeIndicator;
+                }
+
+                return centralItem.smartLauncherItem ? centralItem.smartLauncherItem.count : 0;
+            }
             fullCircle: true
             showNumber: true
             proportion: {
@@ -64,6 +70,10 @@ Item {
                     return 100;
                 }
 
+                if (mainItemContainer.progressIndicator >= 0) {
+                    return mainItemContainer.progressIndicator / 100;
+                }
+
                 if (centralItem.smartLauncherItem) {
                     return centralItem.smartLauncherItem.progress / 100;
                 } else {
@@ -105,6 +105,7 @@ Item {
     property bool disableLeftSpacer: false
     property bool disableRightSpacer: false
     property bool dockIsHidden: latteDock ? latteDock.dockIsHidden : false
+    property bool dockResourcesReleased: latteDock ? latteDock.dockResourcesReleased : false
     property bool exposeAltSession: latteDock ? latteDock.exposeAltSession : false
     property bool highlightWindows: latteDock ? latteDock.highlightWindows: plasmoid.configuration.highlightWindows
     property bool reverseLinesPosition: latteDock ? latteDock.reverseLinesPosition : plasmoid.configuration.reverseLinesPosition
@@ -116,6 +117,8 @@ Item {
     property bool showPreviews:  latteDock ? latteDock.showToolTips : plasmoid.configuration.showToolTips
     property bool showWindowActions: latteDock ? latteDock.showWindowActions : plasmoid.configuration.showWindowActions
     property bool smartLaunchersEnabled: latteDock ? latteDock.smartLaunchersEnabled : plasmoid.configuration.smartLaunchersEnabled
+    //! latte-dock listens to the LauncherEntry API itself, the tasks do not need their own listeners
+    property bool dockProvidesLauncherEntries: taskManagerEndpoint.registered
     property bool threeColorsWindows: latteDock ? latteDock.threeColorsWindows : plasmoid.configuration.threeColorsWindows
 
     property int durationTime: latteDock ? latteDock.durationTime : plasmoid.configuration.durationTime
@@ -428,6 +431,15 @@ Item {
         onTriggered: windowsPreviewDlg.visible = true;
     }
 
+    //! latte-dock dispatches the global shortcuts and the badges through it
+    Latte.TaskManagerEndpoint {
+        id: taskManagerEndpoint
+
+        onActivateTaskAtIndexRequested: root.activateTaskAtIndex(index);
+        onNewInstanceForTaskAtIndexRequested: root.newInstanceForTaskAtIndex(index);
+        onUpdateItemsRequested: root.updateItems(updates);
+    }
+
     /////Window Previews/////////
 
     TaskManager.TasksModel {
@@ -1186,20 +1198,39 @@ Item {
         }
     }
 
-    function updateBadge(identifier, value) {
+    // This is called by dockcorona once per frame with all the merged updates
+    // of external apps, each update holds only the fields that changed
+    function updateItems(updates) {
         var tasks = icList.contentItem.children;
-        var identifierF = identifier.concat(".desktop");
 
-        for(var i=0; i<tasks.length; ++i){
-            var task = tasks[i];
+        for(var j=0; j<updates.length; ++j) {
+            var update = updates[j];
+            var identifierF = update.identifier.concat(".desktop");
 
-            if (task && task.launcherUrl && task.launcherUrl.indexOf(identifierF) >= 0) {
-                task.badgeIndicator = value === "" ? 0 : Number(value);
+            if (update.badge !== undefined) {
                 var badge = getBadger(identifierF);
                 if (badge) {
-                    badge.value = value;
+                    badge.value = update.badge;
                 } else {
-                    badgers.push({id: identifierF, value: value});
+                    badgers.push({id: identifierF, value: update.badge});
+                }
+            }
+
+            for(var i=0; i<tasks.length; ++i){
+                var task = tasks[i];
+
+                if (task && task.launcherUrl && task.launcherUrl.indexOf(identifierF) >= 0) {
+                    if (update.badge !== undefined) {
+                        task.badgeIndicator = update.badge === "" ? 0 : Number(update.badge);
+                    }
+
+                    if (update.progress !== undefined) {
+                        task.progressIndicator = update.progress;
+                    }
+
+                    if (update.urgent !== undefined) {
+                        task.urgentIndicator = update.urgent;
+                    }
                 }
             }
         }
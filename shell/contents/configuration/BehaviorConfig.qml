@@ -160,6 +160,7 @@ PlasmaComponents.Page {
                     target: dock
                     onDockLocationChanged: locationLayout.lockReservedEdges();
                     onDocksCountChanged: locationLayout.lockReservedEdges();
+                    onFreeEdgesChanged: locationLayout.lockReservedEdges();
                 }
 
                 ExclusiveGroup {
@@ -250,6 +250,11 @@ PlasmaCore.FrameSvgItem {
                 removeDock.enabled = (docksCount>1) && !(dock.docksWithTasks()===1 && dock.tasksPresent())
             }
 
+            Connections {
+                target: dock
+                onFreeEdgesChanged: addDock.enabled = actionButtons.docksCount < 4 && dock.freeEdges().length > 0
+            }
+
             PlasmaComponents.Button {
                 id: addDock
                 Layout.alignment: Qt.AlignLeft
@@ -136,6 +136,19 @@ PlasmaComponents.Page {
                 }
             }
 
+            PlasmaComponents.CheckBox {
+                Layout.leftMargin: units.smallSpacing * 2
+                text: globalSettings.standbyMemoryCost > 0 ?
+                          i18n("Keep both sessions loaded (about %1 MiB)", Math.ceil(globalSettings.standbyMemoryCost / 1024)) :
+                          i18n("Keep both sessions loaded")
+                checked: globalSettings.keepSessionsLoaded
+//                tooltip: i18n("The docks of the other session stay in memory so switching sessions is instant")
+
+                onClicked: {
+                    globalSettings.keepSessionsLoaded = checked
+                }
+            }
+
             PlasmaComponents.CheckBox {
                 Layout.leftMargin: units.smallSpacing * 2
                 text: i18n("Raise dock on desktop change")
@@ -0,0 +1,41 @@
+/*
+*  Copyright 2017  Smith AR <audoban@openmailbox.org>
+*                  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+import QtQuick 2.0
+
+//! the root object of the dock window, it is created synchronously and
+//! receives the containment from the view. The dock ui of lattedockui is
+//! incubated asynchronously and placed here when it is ready
+Item {
+    id: root
+
+    property Item containment
+    property Item ui
+
+    onUiChanged: {
+        if (!ui) {
+            return;
+        }
+
+        ui.parent = root;
+        ui.anchors.fill = root;
+        ui.containment = Qt.binding(function() { return root.containment; });
+    }
+}